@@ -0,0 +1,202 @@
+#include "Autosave.h"
+#include "Profiler.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+	bool flushToDisk(std::FILE *file) { //Past the caches of the operating system, so the file survives a power loss as well.
+		if (std::fflush(file) != 0)
+			return false;
+#ifdef _WIN32
+		return _commit(_fileno(file)) == 0;
+#else
+		return fsync(fileno(file)) == 0;
+#endif
+	}
+
+	void writeTemporaryFile(const std::string &temporaryFilePath, const std::string &contents) { //Flushed to disk, to be renamed over the real file.
+		std::FILE *file = std::fopen(temporaryFilePath.c_str(), "wb");
+		if (!file)
+			throw(std::logic_error("Error opening autosave file '" + temporaryFilePath + "'."));
+		bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size() && flushToDisk(file);
+		written = std::fclose(file) == 0 && written;
+		if (!written)
+			throw(std::logic_error("Error writing autosave file '" + temporaryFilePath + "'."));
+	}
+}
+
+Autosave::State Autosave::readState(const std::string &filePath) {
+	std::ifstream file(filePath, std::ios::binary | std::ios::in);
+	if (!file.is_open())
+		throw(std::logic_error("Error opening autosave state file '" + filePath + "'."));
+
+	State state;
+	std::string key;
+	bool complete = false;
+	while (file >> key) {
+		if (key == "generation")
+			file >> state.generation;
+		else if (key == "offset")
+			file >> state.offset.x >> state.offset.y;
+		else if (key == "size")
+			file >> state.worldSize.x >> state.worldSize.y;
+		else if (key == "population")
+			file >> state.population;
+		else if (key == "rules") { //The rest of the file, as it was.
+			file.ignore(1);
+			std::ostringstream rules;
+			rules << file.rdbuf();
+			state.rules = rules.str();
+			complete = true;
+			break;
+		}
+		else
+			break;
+	}
+
+	if (!complete || state.rules.empty())
+		throw(std::logic_error("Autosave state file '" + filePath + "' is not complete."));
+	return state;
+}
+
+Autosave::Autosave(const std::string &fp, std::chrono::seconds i) : filePath{ fp }, interval{ i }, thread{ &Autosave::run, this } {}
+
+Autosave::~Autosave() {
+	handOver(true);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	batchesAvailable.notify_one();
+	thread.join();
+}
+
+void Autosave::clear() {
+	pending.clear();
+	resetPending = true;
+	unsaved = true;
+}
+
+void Autosave::saveIfDue() {
+	bool due = unsaved && std::chrono::steady_clock::now() - lastSaveTime >= interval; //A world that did not change is not written again.
+	if (due || pending.size() >= maxPendingChanges) {
+		PROFILE_SCOPE(autosaving);
+		handOver(due);
+	}
+}
+
+void Autosave::handOver(bool save) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		batches.push_back(Batch{ std::move(pending), worldSize, generation, rules, resetPending, save });
+	}
+	batchesAvailable.notify_one();
+
+	pending = changeContainerType(); //Moved from.
+	resetPending = false;
+	if (save) {
+		lastSaveTime = std::chrono::steady_clock::now();
+		unsaved = false;
+	}
+}
+
+void Autosave::run() {
+	std::vector<Batch> work;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			batchesAvailable.wait(lock, [this] {
+				return stopping || !batches.empty();
+			});
+			if (batches.empty()) //Stopping, and everything has been written.
+				return;
+			work.swap(batches);
+		}
+
+		bool save = false;
+		Position size{ 0, 0 };
+		generationType generation = 0;
+		std::string rules;
+		for (Batch &batch : work) {
+			if (batch.reset)
+				alive.clear();
+			for (auto &change : batch.changes) {
+				if (change.second)
+					alive.insert(change.first);
+				else
+					alive.erase(change.first);
+			}
+			save = save || batch.save;
+			size = batch.worldSize;
+			generation = batch.generation;
+			rules.swap(batch.rules);
+		}
+		work.clear();
+
+		if (save) {
+			try {
+				write(size, generation, rules);
+			}
+			catch (std::exception &e) { //Nobody is waiting for the save, so report it and try again next time.
+				std::cerr << e.what() << "\n";
+			}
+		}
+	}
+}
+
+void Autosave::write(Position size, generationType generation, const std::string &rules) const {
+	std::vector<Position> cells(alive.begin(), alive.end());
+	std::sort(cells.begin(), cells.end(), [](Position pos1, Position pos2) {
+		return pos1.y < pos2.y || (pos1.y == pos2.y && pos1.x < pos2.x);
+	});
+
+	//A world that wraps around is written in full. Otherwise the map starts at the top left corner of the alive cells, and every row ends at its last alive cell.
+	bool wrapAround = size.x > 0;
+	Position topLeft{ 0, 0 }, bottomRight{ size.x - 1, size.y - 1 };
+	if (!wrapAround && !cells.empty()) {
+		topLeft = Position{ cells.front().x, cells.front().y };
+		for (Position pos : cells)
+			topLeft.x = std::min(topLeft.x, pos.x);
+		bottomRight.y = cells.back().y;
+	}
+
+	std::string map;
+	auto it = cells.begin();
+	for (Position::coordType y = topLeft.y; y <= bottomRight.y; ++y) {
+		Position::coordType x = topLeft.x;
+		for (; it != cells.end() && it->y == y; ++it, ++x) {
+			map.append(it->x - x, wrapAround ? '#' : ' ');
+			map += '*';
+			x = it->x;
+		}
+		if (wrapAround)
+			map.append(bottomRight.x + 1 - x, '#');
+		map += '\n';
+	}
+	if (cells.empty() && !wrapAround) //A map needs at least one cell.
+		map = "#\n";
+
+	std::ostringstream state;
+	state << "generation " << generation << "\noffset " << topLeft.x << " " << topLeft.y << "\nsize " << size.x << " " << size.y
+		<< "\npopulation " << cells.size() << "\nrules\n" << rules;
+
+	const std::string stateFilePath = getStateFilePath(filePath);
+	writeTemporaryFile(stateFilePath + ".tmp", state.str());
+	writeTemporaryFile(filePath + ".tmp", map);
+
+	//Each replaces the previous one in one step. A crash in between leaves a map and state file whose populations differ, which readState's caller notices.
+	std::filesystem::rename(stateFilePath + ".tmp", stateFilePath);
+	std::filesystem::rename(filePath + ".tmp", filePath);
+}
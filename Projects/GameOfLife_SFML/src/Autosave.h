@@ -0,0 +1,108 @@
+#ifndef AUTOSAVE_H
+#define AUTOSAVE_H
+
+#include "Position.h"
+#include "MemoryAccounting.h"
+
+#include <unordered_set>
+#include <vector>
+#include <string>
+#include <utility>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstddef>
+
+class Autosave { //Periodically writes the alive cells to a map file, and what the map alone cannot hold to a state file next to it. The simulation thread only hands over the cells that changed since the last hand-over; a background thread keeps its own copy of the world up to date and writes it out, so a save never pauses a tick for longer than moving a vector.
+public:
+	typedef std::vector<std::pair<Position, bool>, TaggedAllocator<std::pair<Position, bool>, MemoryAccounting::autosave>> changeContainerType;
+	typedef unsigned long long generationType;
+
+	class State { //Written to the state file with every save, to resume the world where it was.
+	public:
+		generationType generation{ 0 };
+		Position offset{ 0, 0 }; //Of the top left corner of the map. Maps of infinite worlds start at the top left corner of the alive cells.
+		Position worldSize{ 0, 0 }; //As given to setWorldSize.
+		std::size_t population{ 0 }; //Alive cells in the map, to tell whether the map and the state file were written by the same save.
+		std::string rules; //The text of the rules file.
+	};
+
+	static std::string getStateFilePath(const std::string &mapFilePath) {
+		return mapFilePath + ".state";
+	}
+
+	static State readState(const std::string &filePath); //Throws std::logic_error if it cannot be read.
+
+	static constexpr std::size_t maxPendingChanges = 1 << 20; //Handed over early if this many changes pile up before the next save, so the background thread can keep up.
+
+	Autosave(const std::string &fp, std::chrono::seconds i);
+	~Autosave(); //Writes the world one last time.
+
+	Autosave(const Autosave &) = delete;
+	Autosave &operator=(const Autosave &) = delete;
+
+	void update(Position pos, bool alive) { //Called for each cell that was born or died.
+		pending.emplace_back(pos, alive);
+		unsaved = true;
+	}
+
+	void clear(); //The world is about to be reported again from scratch, through update.
+
+	void setWorldSize(Position size) { //Of a world that wraps around, which is written in full so it can be loaded with --wrap. (0, 0) if the world is infinite.
+		worldSize = size;
+	}
+
+	void setGeneration(generationType g) { //Of the world as handed over next.
+		generation = g;
+	}
+
+	void setRules(const std::string &r) {
+		rules = r;
+		unsaved = true;
+	}
+
+	void saveIfDue(); //Hand the pending changes to the background thread, if it is time to save or they pile up.
+
+	std::chrono::steady_clock::time_point getNextSaveTime() const { //time_point::max() if the world did not change since the last save.
+		return unsaved ? lastSaveTime + interval : std::chrono::steady_clock::time_point::max();
+	}
+
+private:
+	typedef std::unordered_set<Position, PositionHasher, std::equal_to<Position>, TaggedAllocator<Position, MemoryAccounting::autosave>> aliveContainerType;
+
+	class Batch {
+	public:
+		changeContainerType changes;
+		Position worldSize;
+		generationType generation;
+		std::string rules;
+		bool reset; //Forget all alive cells before applying changes.
+		bool save; //Write the world once changes are applied.
+	};
+
+	void handOver(bool save);
+	void run(); //The background thread.
+	void write(Position size, generationType generation, const std::string &rules) const; //To temporary files, flushed to disk and then renamed over the state file and filePath, so a crash never leaves a half written save behind.
+
+	std::string filePath;
+	std::chrono::seconds interval;
+	std::chrono::steady_clock::time_point lastSaveTime{ std::chrono::steady_clock::now() };
+	changeContainerType pending; //Owned by the simulation thread.
+	Position worldSize{ 0, 0 };
+	generationType generation{ 0 };
+	std::string rules;
+	bool resetPending{ false };
+	bool unsaved{ true }; //The world changed since the last save. The first save always happens.
+
+	aliveContainerType alive; //Owned by the background thread.
+
+	std::vector<Batch> batches; //Guarded by mutex.
+	bool stopping{ false };
+	std::mutex mutex;
+	std::condition_variable batchesAvailable;
+	std::thread thread; //Last, so everything it uses exists before it starts.
+};
+
+#endif
\ No newline at end of file
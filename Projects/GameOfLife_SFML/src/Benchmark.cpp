@@ -0,0 +1,204 @@
+#include "Benchmark.h"
+#include "Cell.h"
+#include "FileProcessing.h"
+#include "Torus.h"
+#include "RuleKernels.h"
+
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace {
+	constexpr Cells::generationType defaultGenerations = 1000;
+
+	class QuadVertex { //Laid out like the vertices the window draws, so building them touches the same amount of memory without needing the graphics library.
+	public:
+		float x, y;
+		std::uint8_t color[4];
+		float textureX, textureY;
+	};
+
+	void buildQuads(Cells &cells, std::vector<QuadVertex> &vertices) { //What the window does for every alive cell if the tile cache is disabled.
+		vertices.clear();
+		cells.forEachAliveCell([&vertices](Position pos) {
+			const float x = static_cast<float>(pos.x), y = static_cast<float>(pos.y);
+			vertices.push_back(QuadVertex{ x, y, { 0, 255, 0, 255 }, 0, 0 });
+			vertices.push_back(QuadVertex{ x + 1, y, { 0, 255, 0, 255 }, 0, 0 });
+			vertices.push_back(QuadVertex{ x + 1, y + 1, { 0, 255, 0, 255 }, 0, 0 });
+			vertices.push_back(QuadVertex{ x, y + 1, { 0, 255, 0, 255 }, 0, 0 });
+		});
+	}
+
+	class CacheMissCounter { //Hardware cache misses of the calling thread. Only available on Linux, if perf events are allowed.
+	public:
+		CacheMissCounter() {
+#ifdef __linux__
+			perf_event_attr attributes;
+			std::memset(&attributes, 0, sizeof(attributes));
+			attributes.type = PERF_TYPE_HARDWARE;
+			attributes.size = sizeof(attributes);
+			attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+			attributes.disabled = 1;
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv = 1;
+			fileDescriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+		}
+		CacheMissCounter(const CacheMissCounter&) = delete;
+		CacheMissCounter &operator=(const CacheMissCounter&) = delete;
+
+		~CacheMissCounter() {
+#ifdef __linux__
+			if (available())
+				close(fileDescriptor);
+#endif
+		}
+
+		bool available() const noexcept {
+			return fileDescriptor >= 0;
+		}
+
+		void start() {
+#ifdef __linux__
+			if (available()) {
+				ioctl(fileDescriptor, PERF_EVENT_IOC_RESET, 0);
+				ioctl(fileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+			}
+#endif
+		}
+
+		std::uint64_t stop() { //Misses since start.
+			std::uint64_t misses = 0;
+#ifdef __linux__
+			if (available()) {
+				ioctl(fileDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+				if (read(fileDescriptor, &misses, sizeof(misses)) != sizeof(misses))
+					misses = 0;
+			}
+#endif
+			return misses;
+		}
+
+	private:
+		int fileDescriptor{ -1 };
+	};
+
+	class Measurement {
+	public:
+		std::chrono::nanoseconds time{ 0 };
+		std::uint64_t cacheMisses{ 0 };
+		std::uint64_t cellVisits{ 0 }; //Cells stored (tick) or alive (render), summed over all generations.
+	};
+
+	class Result {
+	public:
+		Measurement tick, render;
+	};
+
+	template<typename F> void measure(Measurement &measurement, CacheMissCounter &counter, F f) {
+		counter.start();
+		auto start = std::chrono::steady_clock::now();
+		f();
+		measurement.time += std::chrono::steady_clock::now() - start;
+		measurement.cacheMisses += counter.stop();
+	}
+
+	Result run(const Options &options, bool zOrder, CacheMissCounter &counter) {
+		Cells cells;
+		processMapRuleFiles(options, &cells);
+		cells.setRecordHistory(false);
+		cells.setZOrder(zOrder);
+
+		Result result;
+		std::vector<QuadVertex> vertices;
+		Cells::generationType generations = options.generations ? options.generations : defaultGenerations;
+		for (Cells::generationType generation = 1; generation <= generations; ++generation) {
+			result.tick.cellVisits += cells.size();
+			measure(result.tick, counter, [&cells] {
+				cells.updateCells();
+			});
+
+			result.render.cellVisits += cells.getStatistics().getPopulation();
+			measure(result.render, counter, [&cells, &vertices] {
+				buildQuads(cells, vertices);
+			});
+
+			if (generation % Cells::maintenanceInterval == 0) //Not measured. Relayouts in Z-order mode.
+				cells.performMaintenance();
+		}
+
+		return result;
+	}
+
+	volatile std::uint64_t changeSink; //Keeps the steps of timeKernel from being optimized away.
+
+	template<typename Kernel> double timeKernel(const Options &options, Kernel kernel) { //Steps a wrap-around grid the size of the map. Returns nanoseconds per cell and generation.
+		Cells cells;
+		processMapRuleFiles(options, &cells);
+		Position mapSize = getMapSize(readFile(options.mapFilePath));
+
+		TorusGrid grid(mapSize.x, mapSize.y);
+		cells.forEachAliveCell([&grid](Position pos) {
+			grid.setAlive(pos, true);
+		});
+
+		Cells::generationType generations = options.generations ? options.generations : defaultGenerations;
+		std::uint64_t changes = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (Cells::generationType generation = 0; generation < generations; ++generation) {
+			grid.step(kernel, [&changes](Position, bool) {
+				++changes;
+			});
+		}
+		std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+		changeSink = changes;
+
+		return time.count() / generations / (double(mapSize.x) * mapSize.y);
+	}
+
+	void print(const char *name, const Measurement &measurement, bool cacheMissesAvailable) {
+		std::cout << "  " << name << ": " << std::chrono::duration_cast<std::chrono::milliseconds>(measurement.time).count() << " ms";
+		if (measurement.cellVisits) {
+			std::cout << ", " << measurement.time.count() / measurement.cellVisits << " ns per cell";
+			if (cacheMissesAvailable)
+				std::cout << ", " << static_cast<double>(measurement.cacheMisses) / measurement.cellVisits << " cache misses per cell";
+		}
+		std::cout << "\n";
+	}
+}
+
+int runBenchmark(const Options &options) {
+	CacheMissCounter counter;
+	if (!counter.available())
+		std::cout << "Cache misses cannot be counted on this system. Only times are shown.\n";
+
+	Result hashed = run(options, false, counter);
+	Result zOrder = run(options, true, counter);
+
+	std::cout << "Hashed layout:\n";
+	print("tick", hashed.tick, counter.available());
+	print("render", hashed.render, counter.available());
+	std::cout << "Z-order layout:\n";
+	print("tick", zOrder.tick, counter.available());
+	print("render", zOrder.render, counter.available());
+
+	Cells cells;
+	processMapRuleFiles(options, &cells);
+	const Parser::transitionTableType &transitionTable = cells.getRules().getTransitionTable();
+	std::cout << "Rule kernels for " << RuleMasks(transitionTable).toString() << ", on a wrap-around grid the size of the map:\n";
+	withRuleKernel(transitionTable, [&](auto kernel) {
+		std::cout << "  selected: " << timeKernel(options, kernel) << " ns per cell\n";
+	});
+	std::cout << "  table: " << timeKernel(options, TableRuleKernel(transitionTable)) << " ns per cell\n";
+
+	return 0;
+}
@@ -0,0 +1,8 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "Options.h"
+
+int runBenchmark(const Options &options); //Simulate and render the map once with hashed and once with Z-order storage, then print the time and cache misses of each. Returns the exit code for main.
+
+#endif
\ No newline at end of file
@@ -1,36 +1,83 @@
 ﻿#include <vector>
 #include <chrono>
 #include <utility>
-
-#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <stdexcept>
 
 #include "Cell.h"
-#include "Window.h"
-#include "Map.h"
-
-sf::Vector2f Cell::size(60, 60);
+#include "Profiler.h"
+#include "Trace.h"
 
 void Cells::updateCells() {
+	PROFILE_SCOPE(tick);
+
 	history.next();
+	statistics.nextGeneration();
+	++generation;
+	lastChanges.clear();
+
+	if (torus) { //Bounded world: no expansion or lookups needed.
+		PROFILE_SCOPE(ruleEvaluation); //Evaluating the rules and applying the futures happen in the same pass.
+		withRuleKernel(rules.getTransitionTable(), [this](auto kernel) {
+			torus->step(kernel, [this](Position pos, bool alive) {
+				lastChanges.emplace_back(pos, alive);
+			});
+		});
+	}
+	else {
+		updateInfiniteCells();
+	}
 
-	for (Cell &cell : *this) {
-		expandIfNecessary(cell); //Expand cells when necessary.
+	PROFILE_SCOPE(recordingChanges);
+	for (auto &change : lastChanges) {
+		history.appendChange(change.first, change.second);
+		onCellChanged(change.first, change.second);
 	}
 
-	for (Cell &cell : *this) {
-		rules(cell, *this); //Evaluate rules and set the 'future'(futureAlive) of the cell.
+	if (cycleDetector)
+		cycleDetector->record(generation, worldHash, statistics.getBoundingBoxMin(), !torus); //Translations are not meaningful when the world wraps around.
+}
+
+void Cells::updateInfiniteCells() {
+	{
+		PROFILE_SCOPE(expansion);
+
+		cellsToExpand.clear(); //Inserting while iterating over cellsContainer could rehash it, so collect the cells first. (References to elements stay valid.)
+		for (Cell &cell : *this) {
+			if (cell.neighborCount() < 8 && cell.getAlive())
+				cellsToExpand.push_back(&cell);
+		}
+
+		for (Cell *cell : cellsToExpand) {
+			expandIfNecessary(*cell); //Expand cells when necessary.
+		}
 	}
 
-	for (Cell &cell : *this) { //Apply the 'futures' to the cells.
+	{
+		PROFILE_SCOPE(ruleEvaluation);
+
+		withRuleKernel(rules.getTransitionTable(), [this](auto kernel) {
+			for (Cell &cell : *this) { //Evaluate rules and set the 'future'(futureAlive) of the cell.
+				cell.setFutureAlive(kernel(cell.getAlive(), static_cast<int>(aliveNeighborCount(cell, *this))));
+			}
+		});
+	}
+
+	PROFILE_SCOPE(applyingFutures);
+	for (Cell &cell : *this) { //Apply the 'futures' to the cells. The changes are recorded by updateCells.
 		bool future = cell.getFutureAlive();
 		if (cell.getAlive() != future) {
 			cell.setAlive(future);
-			historyAppendChange(cell);
+			lastChanges.emplace_back(cell.getPosition(), future);
 		}
 	}
 }
 
-void Cells::update() {
+bool Cells::update() {
 	auto lastTickTime = std::chrono::steady_clock::now() - tickStartTime;
 	timePassedSinceLastTick += std::chrono::duration_cast<std::chrono::nanoseconds>(lastTickTime);
 	timePassedSinceLastMaintenance += std::chrono::duration_cast<std::chrono::nanoseconds>(lastTickTime);
@@ -41,42 +88,95 @@ void Cells::update() {
 		timePassedSinceLastMaintenance = std::chrono::nanoseconds{ 0 };
 	}
 
+	autosaveIfDue(); //Edits made while paused are saved as well.
+
+	if (jump) { //A slice of the jump per call, so the window keeps drawing and handling input in between.
+		try {
+			continueJump(jumpSliceTime);
+		}
+		catch (std::exception &) {} //Reported through getLastJump.
+		return true;
+	}
+
+	//The time past the aim is carried over to the next tick, so ticks keep their average rate even though each one is noticed a little late. If a whole tick was missed, the schedule is reset rather than catching up.
+	auto finishTick = [this](std::chrono::milliseconds aimTime) {
+		timePassedSinceLastTick -= aimTime;
+		if (timePassedSinceLastTick > aimTime)
+			timePassedSinceLastTick = std::chrono::nanoseconds{ 0 };
+	};
+
 	if (!getPause()) {
 		if (!getRewinding()) {
 			if (timePassedSinceLastTick > getTickAimTime()) {
 				updateCells();
-				timePassedSinceLastTick = std::chrono::nanoseconds{ 0 };
+				finishTick(getTickAimTime());
+
+				if (pauseOnCycle && cycleDetector && cycleDetector->found()) {
+					setPause(true);
+					pauseOnCycle = false; //Only once, so the user can continue.
+				}
+				return true;
 			}
 		}
 		else {
 			if (timePassedSinceLastTick > getTickRewindAimTime()) {
 				history.last();
-				timePassedSinceLastTick = std::chrono::nanoseconds{ 0 };
+				finishTick(getTickRewindAimTime());
+				return true;
 			}
 		}
 	}
-}
 
-void Cells::render(Window &window) const {
-	vertices.clear();
+	return false;
+}
 
-	auto last = cend();
-	for (auto beg = cbegin(); beg != last; ++beg) {
-		const Cell &cell = *beg;
-		const Position pos = cell.getPosition();
-		const sf::Vector2f finalBegPos(pos.x * cell.size.x, pos.y * cell.size.y);
+std::chrono::steady_clock::time_point Cells::getNextUpdateTime() const {
+	if (jump)
+		return std::chrono::steady_clock::time_point::min(); //Right away.
 
-		if (cell.getAlive()) {
-			vertices.emplace_back(sf::Vector2f(finalBegPos.x, finalBegPos.y), sf::Color::Green);
-			vertices.emplace_back(sf::Vector2f(finalBegPos.x + cell.size.x, finalBegPos.y), sf::Color::Green);
-			vertices.emplace_back(sf::Vector2f(finalBegPos.x + cell.size.x, finalBegPos.y + cell.size.y), sf::Color::Green);
-			vertices.emplace_back(sf::Vector2f(finalBegPos.x, finalBegPos.y + cell.size.y), sf::Color::Green);
-		}
+	auto nextUpdateTime = std::chrono::steady_clock::time_point::max();
+	if (!getPause()) {
+		const auto aimTime = getRewinding() ? getTickRewindAimTime() : getTickAimTime();
+		nextUpdateTime = tickStartTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(aimTime - timePassedSinceLastTick) + std::chrono::nanoseconds(1); //update only ticks once strictly more than aimTime passed.
 	}
+	if (autosave)
+		nextUpdateTime = std::min(nextUpdateTime, autosave->getNextSaveTime());
+
+	return nextUpdateTime;
+}
 
-	window.getSFMLWindow().setView(window.getView());
+void Cells::addChangeListener(ChangeListener &listener) {
+	changeListeners.push_back(&listener);
+	forEachAliveCell([&listener](Position pos) {
+		listener.update(pos, true);
+	});
+}
+
+void Cells::removeChangeListener(ChangeListener &listener) {
+	changeListeners.erase(std::remove(changeListeners.begin(), changeListeners.end(), &listener), changeListeners.end());
+}
 
-	window.getSFMLWindow().draw(vertices.data(), vertices.size(), sf::Quads);
+Cells::~Cells() {
+	Autosave *lastAutosave = autosave ? autosave.get() : jump ? jump->detachedAutosave.get() : nullptr;
+	if (lastAutosave)
+		lastAutosave->setGeneration(generation);
+}
+
+void Cells::setAutosave(const std::string &filePath, std::chrono::seconds interval) {
+	if (autosave)
+		autosave->setGeneration(generation);
+	autosave = nullptr; //Writes the previous save first.
+	if (filePath.empty())
+		return;
+
+	autosave = std::make_unique<Autosave>(filePath, interval);
+	autosave->setGeneration(generation);
+	autosave->setRules(rulesText);
+	if (torus)
+		autosave->setWorldSize(Position{ torus->getWidth(), torus->getHeight() });
+	forEachAliveCell([this](Position pos) {
+		autosave->update(pos, true);
+	});
 }
 
 void Cells::addNeighborsToAllCells() {
@@ -89,6 +189,106 @@ void Cells::addNeighborsToAllCells() {
 	}
 }
 
+void Cells::bulkInsert(const changeContainerType &newCells) {
+	if (!cellsContainer.empty() || torus)
+		throw(std::logic_error("Cells can only be inserted in bulk into an empty, infinite world."));
+	if (newCells.empty())
+		return;
+
+	//Index the cells by their place in their bounding box, grown by one cell on each side to make room for the dead cells around the alive ones.
+	Position topLeft = newCells.front().first, bottomRight = topLeft;
+	for (auto &newCell : newCells) {
+		topLeft = Position{ std::min(topLeft.x, newCell.first.x), std::min(topLeft.y, newCell.first.y) };
+		bottomRight = Position{ std::max(bottomRight.x, newCell.first.x), std::max(bottomRight.y, newCell.first.y) };
+	}
+	topLeft = topLeft - Position{ 1, 1 };
+	bottomRight = bottomRight + Position{ 1, 1 };
+
+	typedef std::make_unsigned_t<Position::coordType> unsignedCoordType; //The width of a bounding box far from the origin may not fit into Position::coordType.
+	std::size_t width = static_cast<std::size_t>(unsignedCoordType(bottomRight.x) - unsignedCoordType(topLeft.x)) + 1, height = static_cast<std::size_t>(unsignedCoordType(bottomRight.y) - unsignedCoordType(topLeft.y)) + 1;
+
+	//The index takes 4 bytes for every position of the bounding box. If the cells are spread thinly over it, such as a long row and a long column, insert them one by one instead, so the memory follows the amount of cells.
+	const std::size_t maxIndexedPositions = std::max<std::size_t>(newCells.size() * maxIndexedPositionsPerCell, std::size_t(1) << 16);
+	if (height > maxIndexedPositions / width) {
+		for (auto &newCell : newCells)
+			insert(std::make_pair(newCell.first, Cell(newCell.first, newCell.second)));
+		addNeighborsToAllCells();
+		return;
+	}
+
+	constexpr std::uint32_t noCell = std::numeric_limits<std::uint32_t>::max(), borderCell = noCell - 1;
+	std::vector<std::uint32_t> cellIndices(width * height, noCell);
+	auto getCellIndex = [&cellIndices, topLeft, width](Position pos) -> std::uint32_t & {
+		return cellIndices[static_cast<std::size_t>(pos.y - topLeft.y) * width + (pos.x - topLeft.x)];
+	};
+
+	//The same order as addNeighbors.
+	static const std::array<Position, 8> neighborOffsets{ { { 0, -1 }, { 1, -1 }, { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 } } };
+
+	//Mark the cells of the map, and the dead cells the first tick would add around the alive ones in expandIfNecessary, so the cells can be built in one allocation.
+	std::size_t cellCount = 0;
+	for (auto &newCell : newCells) {
+		std::uint32_t &cellIndex = getCellIndex(newCell.first);
+		if (cellIndex == noCell) {
+			cellIndex = borderCell;
+			++cellCount;
+		}
+	}
+	for (auto &newCell : newCells) {
+		if (!newCell.second)
+			continue;
+		for (Position offset : neighborOffsets) {
+			std::uint32_t &cellIndex = getCellIndex(newCell.first + offset);
+			if (cellIndex == noCell) {
+				cellIndex = borderCell;
+				++cellCount;
+			}
+		}
+	}
+
+	std::vector<Cell> builtCells;
+	builtCells.reserve(cellCount);
+	for (auto &newCell : newCells) {
+		std::uint32_t &cellIndex = getCellIndex(newCell.first);
+		if (cellIndex == borderCell) { //Like insert, the first cell at a position is kept.
+			cellIndex = static_cast<std::uint32_t>(builtCells.size());
+			builtCells.emplace_back(newCell.first, newCell.second);
+		}
+	}
+	for (auto &newCell : newCells) {
+		if (!newCell.second)
+			continue;
+		for (Position offset : neighborOffsets) {
+			std::uint32_t &cellIndex = getCellIndex(newCell.first + offset);
+			if (cellIndex == borderCell) {
+				cellIndex = static_cast<std::uint32_t>(builtCells.size());
+				builtCells.emplace_back(newCell.first + offset, false);
+			}
+		}
+	}
+
+	for (Cell &cell : builtCells) {
+		Position cellPosition = cell.getPosition();
+		for (Position offset : neighborOffsets) {
+			Position neighborPosition = cellPosition + offset;
+			if (neighborPosition.x >= topLeft.x && neighborPosition.y >= topLeft.y && neighborPosition.x <= bottomRight.x && neighborPosition.y <= bottomRight.y && getCellIndex(neighborPosition) != noCell)
+				cell.addNeighborPosition(neighborPosition);
+		}
+	}
+
+	//Inserted bucket by bucket, so the buckets and the chains are written in order instead of at random.
+	cellsContainer.reserve(builtCells.size());
+	std::vector<std::uint64_t> insertionOrder(builtCells.size()); //Bucket in the upper half, index into builtCells in the lower half.
+	for (std::size_t i = 0; i < builtCells.size(); ++i)
+		insertionOrder[i] = (static_cast<std::uint64_t>(cellsContainer.bucket(builtCells[i].getPosition())) << 32) | i;
+	std::sort(insertionOrder.begin(), insertionOrder.end());
+
+	for (std::uint64_t order : insertionOrder) {
+		const Cell &cell = builtCells[static_cast<std::uint32_t>(order)];
+		insert(std::make_pair(cell.getPosition(), cell));
+	}
+}
+
 void Cells::addNeighbors(Cell &cell) {
 	Position cellPosition = cell.getPosition();
 
@@ -170,54 +370,467 @@ void Cells::addEmptyNeighborToCellsIfPossible(Position pos) { //Add a new cell t
 }
 
 void Cells::CellsHistory::appendChange(Cell &cell) {
-	if (currentIndex == cellsChangeContainer.size() - 1)
-		cellsChangeContainer.back().push_back(std::make_pair(cell.getPosition(), cell.getAlive()));
+	appendChange(cell.getPosition(), cell.getAlive());
+}
+
+void Cells::CellsHistory::appendChange(Position pos, bool alive) {
+	if (recording && currentIndex == tickBegins.size() - 1)
+		changes.push_back(std::make_pair(pos, alive));
 }
 
 void Cells::CellsHistory::next() {
-	if (currentIndex == cellsChangeContainer.size() - 1) {
+	if (!recording) {
+		setLookingThroughHistory(false);
+		return;
+	}
+
+	if (currentIndex == tickBegins.size() - 1) {
 		setLookingThroughHistory(false);
-		cellsChangeContainer.emplace_back();
+		tickBegins.push_back(changes.size());
+		editEntries.push_back(false);
+		++currentIndex;
+	}
+}
+
+void Cells::CellsHistory::beginEdit() {
+	removeFuture();
+	setLookingThroughHistory(false);
+
+	if (recording) {
+		tickBegins.push_back(changes.size());
+		editEntries.push_back(true);
 		++currentIndex;
 	}
 }
 
 void Cells::CellsHistory::last() {
+	TRACE_SCOPE("history step back");
 	setLookingThroughHistory(true);
 
 	if (currentIndex > 0) {
-		std::vector<std::pair<Position, bool>> &currContainer = cellsChangeContainer[currentIndex];
-		for (auto &changes : currContainer) { //Iterate through the changes and apply the opposite of what is stored.
-			Position pos = changes.first;
-			bool alive = changes.second;
-
-			Cell *result = associatedCells->find(pos);
-			if (result)
-				result->setAlive(!alive);
-			else {
-				Cell &cell = associatedCells->insert(std::make_pair(pos, Cell(pos, !alive)));
-				associatedCells->addNeighbors(cell);
-				associatedCells->addAsNeighborToEachNeighbor(cell);
-			}
+		ChangeArena::size_type end = currentIndex + 1 < tickBegins.size() ? tickBegins[currentIndex + 1] : changes.size();
+		bool edit = editEntries[currentIndex];
+		if (!edit)
+			associatedCells->statistics.nextGeneration();
+		for (ChangeArena::size_type i = end; i-- > tickBegins[currentIndex];) { //Iterate backwards through the changes and apply the opposite of what is stored. (Edits may change a cell more than once.)
+			associatedCells->restoreCell(changes[i].first, !changes[i].second);
 		}
 		--currentIndex;
+		if (!edit)
+			--associatedCells->generation;
+
+		if (associatedCells->cycleDetector)
+			associatedCells->cycleDetector->clear(); //The recorded generations are in the future now.
 	}
 }
 
 void Cells::CellsHistory::removeFuture() {
-	if (currentIndex != cellsChangeContainer.size() - 1)
-		cellsChangeContainer.erase(cellsChangeContainer.begin() + currentIndex + 1, cellsChangeContainer.end());
+	TRACE_SCOPE("history remove future");
+	if (currentIndex != tickBegins.size() - 1) {
+		changes.truncate(tickBegins[currentIndex + 1]);
+		tickBegins.resize(currentIndex + 1);
+		editEntries.resize(currentIndex + 1);
+	}
+}
+
+void Cells::CellsHistory::clear() {
+	changes.truncate(0);
+	tickBegins.assign(1, 0);
+	editEntries.assign(1, false);
+	currentIndex = 0;
+}
+
+void Cells::ChangeArena::push_back(const value_type &change) {
+	size_type chunkIndex = changeCount / chunkSize;
+	if (chunkIndex == chunks.size()) {
+		chunks.emplace_back();
+		chunks.back().reserve(chunkSize);
+	}
+
+	chunks[chunkIndex].push_back(change);
+	++changeCount;
+}
+
+void Cells::ChangeArena::truncate(size_type newSize) {
+	if (newSize >= changeCount)
+		return;
+
+	for (size_type chunkIndex = newSize / chunkSize; chunkIndex < chunks.size(); ++chunkIndex) //Keeps the capacity of the chunks.
+		chunks[chunkIndex].resize(chunkIndex == newSize / chunkSize ? newSize % chunkSize : 0);
+	changeCount = newSize;
 }
 
 void Cells::CellsHistory::setLookingThroughHistory(bool lth) {
 	if (lookingThroughHistory != lth) {
 		lookingThroughHistory = lth;
 		if (!lth) {
+			TRACE_SCOPE("history resume");
 			associatedCells->addNeighborsToAllCells(); //Add neighbors if we stopped looking through history.
 		}
 	}
 }
 
+void Cells::restoreCell(Position pos, bool alive) {
+	if (torus) {
+		if (torus->getAlive(pos) != alive) {
+			onCellChanged(pos, alive);
+			torus->setAlive(pos, alive);
+		}
+		return;
+	}
+
+	Cell *result = find(pos);
+	if (result) {
+		if (result->getAlive() != alive)
+			onCellChanged(pos, alive);
+		result->setAlive(alive);
+	}
+	else { //insert reports the change.
+		Cell &cell = insert(std::make_pair(pos, Cell(pos, alive)));
+		addNeighbors(cell);
+		addAsNeighborToEachNeighbor(cell);
+	}
+}
+
+void Cells::onCellChanged(Position pos, bool alive) {
+	++changeCount;
+	statistics.update(pos, alive);
+
+	if (cycleDetector)
+		worldHash.update(pos, alive);
+
+	if (autosave)
+		autosave->update(pos, alive);
+
+	for (ChangeListener *listener : changeListeners)
+		listener->update(pos, alive);
+}
+
+void Cells::recount() {
+	++changeCount; //Even if nothing is alive.
+	statistics.clear();
+	worldHash.clear();
+	if (autosave)
+		autosave->clear();
+	for (ChangeListener *listener : changeListeners)
+		listener->clear();
+
+	forEachAliveCell([this](Position pos) {
+		onCellChanged(pos, true);
+	});
+
+	statistics.nextGeneration(); //Recounting is not a birth.
+}
+
+void Cells::setGeneration(generationType g) {
+	throwIfJumping("set the generation");
+	generation = g;
+	history.clear();
+	if (cycleDetector) { //Recorded generations would be mixed with the new ones.
+		cycleDetector->clear();
+		cycleDetector->record(generation, worldHash, statistics.getBoundingBoxMin(), !torus);
+	}
+}
+
+void Cells::setCycleDetection(bool enabled) {
+	if (enabled) {
+		cycleDetector = std::make_unique<CycleDetector>();
+		recount();
+		cycleDetector->record(generation, worldHash, statistics.getBoundingBoxMin(), !torus);
+	}
+	else
+		cycleDetector = nullptr;
+}
+
+namespace {
+	//The offset of one coordinate after periods periods of displacement, if the cells between first and last, along with the dead cells around them, still fit into Position::coordType once moved by it. Computed without overflowing.
+	bool getSkipOffset(Position::coordType displacement, Cells::generationType periods, Position::coordType first, Position::coordType last, Position::coordType &offset) {
+		typedef Cells::generationType unsignedType; //At least 64 bits, so it holds the distance between any two coordinates.
+		constexpr Position::coordType lowest = std::numeric_limits<Position::coordType>::min() + 1, highest = std::numeric_limits<Position::coordType>::max() - 1;
+
+		offset = 0;
+		if (!displacement)
+			return true;
+		if (first < lowest || last > highest)
+			return false;
+
+		unsignedType step = displacement < 0 ? unsignedType(0) - unsignedType(displacement) : unsignedType(displacement);
+		unsignedType room = displacement < 0 ? unsignedType(first) - unsignedType(lowest) : unsignedType(highest) - unsignedType(last);
+		if (periods > room / step || step * periods > unsignedType(std::numeric_limits<Position::coordType>::max()))
+			return false;
+
+		Position::coordType distance = Position::coordType(step * periods);
+		offset = displacement < 0 ? -distance : distance;
+		return true;
+	}
+
+	Position::coordType getWrappedSkipOffset(Position::coordType displacement, Cells::generationType periods, Position::coordType size) { //The same in a world that wraps around, in which only the offset modulo the size matters.
+		Cells::generationType wrappedDisplacement = Cells::generationType(((displacement % size) + size) % size);
+		return Position::coordType((periods % Cells::generationType(size)) * wrappedDisplacement % Cells::generationType(size));
+	}
+}
+
+bool Cells::skipCycles(generationType targetGeneration) {
+	if (!cycleDetector || !cycleDetector->found() || targetGeneration <= generation)
+		return false;
+
+	TRACE_SCOPE("skip cycles");
+	const CycleDetector::Cycle cycle = cycleDetector->getCycle();
+	generationType periodsToSkip = (targetGeneration - generation) / cycle.period;
+	if (!periodsToSkip)
+		return false;
+
+	if (cycle.displacement != Position{ 0, 0 }) {
+		Position offset;
+		if (torus)
+			offset = Position{ getWrappedSkipOffset(cycle.displacement.x, periodsToSkip, torus->getWidth()), getWrappedSkipOffset(cycle.displacement.y, periodsToSkip, torus->getHeight()) };
+		else {
+			Position first = statistics.getBoundingBoxMin(), last = statistics.getBoundingBoxMax();
+			if (!getSkipOffset(cycle.displacement.x, periodsToSkip, first.x, last.x, offset.x) || !getSkipOffset(cycle.displacement.y, periodsToSkip, first.y, last.y, offset.y))
+				throw(std::overflow_error("By generation " + std::to_string(generation + periodsToSkip * cycle.period) + " the cells would move beyond the largest coordinates. Build with GOL_64BIT_COORDINATES defined for worlds this large."));
+		}
+		translate(offset);
+	}
+
+	generation += periodsToSkip * cycle.period;
+	history.clear(); //The skipped generations were never recorded.
+	cycleDetector->clear();
+
+	return true;
+}
+
+void Cells::beginJump(generationType targetGeneration) {
+	if (jump)
+		throw(std::logic_error("A jump is already in progress."));
+	if (targetGeneration < generation)
+		throw(std::invalid_argument("Generation " + std::to_string(targetGeneration) + " is in the past, at generation " + std::to_string(generation) + ". Step backward through history instead."));
+
+	jump = std::make_unique<Jump>();
+	jump->target = targetGeneration;
+	jump->start = std::chrono::steady_clock::now();
+	jump->report.from = generation;
+
+	setRewind(false);
+	setPause(true);
+	history.removeFuture();
+
+	//Nothing but the simulation itself sees the generations in between. Whatever is detached is rebuilt from the final world by recount.
+	jump->detachedChangeListeners = std::move(changeListeners);
+	changeListeners.clear();
+	jump->detachedAutosave = std::move(autosave);
+	jump->recording = history.getRecording();
+	jump->detectingCycles = cycleDetector != nullptr;
+	history.setRecording(false);
+	if (!jump->detectingCycles)
+		setCycleDetection(true);
+}
+
+bool Cells::continueJump(std::chrono::nanoseconds timeLimit) {
+	if (!jump)
+		return true;
+
+	TRACE_SCOPE("jump");
+	const auto sliceStart = std::chrono::steady_clock::now();
+	try {
+		while (generation < jump->target) {
+			updateCells();
+			if (generation % maintenanceInterval == 0)
+				performMaintenance();
+
+			if (cycleDetector->found())
+				jump->report.skippedCycles = skipCycles(jump->target) || jump->report.skippedCycles;
+
+			if (generation < jump->target && std::chrono::steady_clock::now() - sliceStart >= timeLimit)
+				return false;
+		}
+	}
+	catch (std::exception &e) { //Stop at the generation reached, which is shown like any other.
+		jump->report.error = e.what();
+		finishJump();
+		throw;
+	}
+
+	finishJump();
+	return true;
+}
+
+void Cells::cancelJump() {
+	if (!jump)
+		return;
+
+	jump->report.cancelled = true;
+	finishJump();
+}
+
+void Cells::finishJump() {
+	history.clear(); //The generations in between were never recorded.
+	history.setRecording(jump->recording);
+	if (!jump->detectingCycles)
+		cycleDetector = nullptr;
+	changeListeners = std::move(jump->detachedChangeListeners);
+	autosave = std::move(jump->detachedAutosave);
+	recount();
+
+	jump->report.to = generation;
+	jump->report.timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - jump->start);
+	lastJump = std::move(jump->report);
+	jump = nullptr;
+}
+
+Cells::JumpReport Cells::jumpTo(generationType targetGeneration) {
+	beginJump(targetGeneration);
+	continueJump(std::chrono::nanoseconds::max());
+	return lastJump;
+}
+
+Cells::generationType Cells::getStepTarget(unsigned exponent) const {
+	if (exponent > maxStepExponent)
+		throw(std::invalid_argument("Cannot step 2^" + std::to_string(exponent) + " generations. The largest step is 2^" + std::to_string(maxStepExponent) + "."));
+
+	const generationType step = generationType(1) << exponent;
+	if (std::numeric_limits<generationType>::max() - generation < step)
+		throw(std::invalid_argument("Stepping 2^" + std::to_string(exponent) + " generations would overflow the generation counter."));
+
+	return generation + step;
+}
+
+Cells::JumpReport Cells::stepPowerOfTwo(unsigned exponent) {
+	return jumpTo(getStepTarget(exponent));
+}
+
+void Cells::translate(Position offset) {
+	std::vector<Position> alivePositions;
+	forEachAliveCell([&alivePositions](Position pos) {
+		alivePositions.push_back(pos);
+	});
+
+	if (torus) {
+		for (Position pos : alivePositions)
+			torus->setAlive(pos, false);
+		for (Position pos : alivePositions)
+			torus->setAlive(torus->wrap(pos + offset), true);
+	}
+	else {
+		cellsContainer.clear();
+		for (Position pos : alivePositions)
+			insert(std::make_pair(pos + offset, Cell(pos + offset, true)));
+		addNeighborsToAllCells();
+	}
+
+	history.clear();
+	recount();
+
+	if (cycleDetector) {
+		cycleDetector->clear();
+		cycleDetector->record(generation, worldHash, statistics.getBoundingBoxMin(), !torus);
+	}
+}
+
+bool Cells::getAlive(Position pos) const {
+	if (torus)
+		return torus->getAlive(torus->wrap(pos));
+
+	auto it = cellsContainer.find(pos);
+	return it != cellsContainer.end() && it->second.getAlive();
+}
+
+void Cells::applyEdits(changeContainerType &edits) {
+	throwIfJumping("edit cells");
+	TRACE_SCOPE("edit");
+
+	if (torus) {
+		for (auto &edit : edits)
+			edit.first = torus->wrap(edit.first);
+	}
+	std::stable_sort(edits.begin(), edits.end(), [](const changeContainerType::value_type &edit1, const changeContainerType::value_type &edit2) { //Cells close together are edited together. Stable, so the last edit of a position wins.
+		return MortonHasher::getKey(edit1.first) < MortonHasher::getKey(edit2.first);
+	});
+
+	history.beginEdit();
+	newCells.clear();
+
+	for (auto &edit : edits) {
+		Position pos = edit.first;
+		bool alive = edit.second;
+
+		if (torus) {
+			if (torus->getAlive(pos) == alive)
+				continue;
+			torus->setAlive(pos, alive);
+		}
+		else if (alive) {
+			auto result = cellsContainer.emplace(pos, Cell(pos, true)); //Neighbors are connected once all cells exist.
+			if (result.second)
+				newCells.push_back(&result.first->second);
+			else if (result.first->second.getAlive())
+				continue;
+			else
+				result.first->second.setAlive(true);
+		}
+		else {
+			Cell *cell = find(pos);
+			if (!cell || !cell->getAlive()) //Do not create dead cells.
+				continue;
+			cell->setAlive(false);
+		}
+
+		history.appendChange(pos, alive);
+		onCellChanged(pos, alive);
+	}
+
+	connectNewCells();
+
+	if (cycleDetector) { //The world did not get here by following the rules.
+		cycleDetector->clear();
+		cycleDetector->record(generation, worldHash, statistics.getBoundingBoxMin(), !torus);
+	}
+}
+
+void Cells::connectNewCells() {
+	if (newCells.empty())
+		return;
+
+	if (newCells.size() > cellsContainer.size() / 4) { //Large stamps: rebuilding every neighbor list at once is cheaper.
+		addNeighborsToAllCells();
+		return;
+	}
+
+	auto isNew = [this](Position pos) { //newCells is in Z-order.
+		std::uint64_t key = MortonHasher::getKey(pos);
+		auto it = std::lower_bound(newCells.begin(), newCells.end(), key, [](const Cell *cell, std::uint64_t k) {
+			return MortonHasher::getKey(cell->getPosition()) < k;
+		});
+		for (; it != newCells.end() && MortonHasher::getKey((*it)->getPosition()) == key; ++it) { //With 64 bit coordinates, positions 2^32 apart share a key.
+			if ((*it)->getPosition() == pos)
+				return true;
+		}
+		return false;
+	};
+
+	for (Cell *cell : newCells) {
+		addNeighbors(*cell); //Finds new and old neighbors.
+		for (Position neighborPos : cell->getNeighborsPositions()) {
+			if (!isNew(neighborPos)) //New neighbors add this cell themselves.
+				find(neighborPos)->addNeighborPosition(cell->getPosition());
+		}
+	}
+}
+
+void Cells::setWrapAround(Position::coordType width, Position::coordType height) {
+	torus = std::make_unique<TorusGrid>(width, height);
+
+	for (Cell &cell : *this) {
+		Position pos = cell.getPosition();
+		if (cell.getAlive() && pos.x >= 0 && pos.y >= 0 && pos.x < width && pos.y < height)
+			torus->setAlive(pos, true);
+	}
+
+	cellsContainer.clear();
+	if (autosave)
+		autosave->setWorldSize(Position{ width, height });
+	recount(); //Cells outside of the map are gone.
+}
+
 void Cells::removeCell(Cell &cell) { //Remove cell and remove cell from neighbors' neighbors container.
 	for (Position neighborPos : cell.getNeighborsPositions()) {
 		Cell &neighbor = *find(neighborPos);
@@ -234,6 +847,8 @@ void Cells::removeCell(Cell &cell) { //Remove cell and remove cell from neighbor
 }
 
 void Cells::performMaintenance() {
+	PROFILE_SCOPE(maintenance);
+
 	for (auto beg = begin(); beg != end(); ) {
 		if (!beg->getAlive() && !beg->hasAliveNeighbor(*this)) {
 			auto copy = beg;
@@ -243,11 +858,46 @@ void Cells::performMaintenance() {
 		else
 			++beg;
 	}
+
+	if (getZOrder())
+		relayout(); //Cells added since the last maintenance were placed wherever memory was free.
+
+	for (ChangeListener *listener : changeListeners)
+		listener->maintain();
+}
+
+void Cells::setZOrder(bool zOrder) {
+	if (zOrder == getZOrder())
+		return;
+
+	cellsContainerType newContainer(cellsContainer.bucket_count(), CellsHasher(zOrder));
+	for (auto &pair : cellsContainer) //Neighbors are stored as positions, so they stay valid.
+		newContainer.emplace(pair);
+	cellsContainer.swap(newContainer);
+
+	if (zOrder)
+		relayout();
+}
+
+void Cells::relayout() {
+	PROFILE_SCOPE(relayout);
+
+	relayoutBuffer.clear();
+	for (auto &pair : cellsContainer)
+		relayoutBuffer.push_back(pair.second);
+	std::sort(relayoutBuffer.begin(), relayoutBuffer.end(), [](const Cell &cell1, const Cell &cell2) {
+		return MortonHasher::getKey(cell1.getPosition()) < MortonHasher::getKey(cell2.getPosition());
+	});
+
+	cellsContainer.clear(); //Keeps the buckets.
+	PoolBase::sortAllFreeLists();
+	for (const Cell &cell : relayoutBuffer) //Neither births nor deaths, so insert is not used.
+		cellsContainer.emplace(cell.getPosition(), cell);
 }
 
 bool Cell::hasAliveNeighbor(Cells &cells) {
 	for (Position neighborPos : neighborsPositions) {
-		if (cells.find(getPosition())->getAlive())
+		if (cells.find(neighborPos)->getAlive())
 			return true;
 	}
 	return false;
@@ -255,23 +905,6 @@ bool Cell::hasAliveNeighbor(Cells &cells) {
 
 void Cells::addAsNeighborToEachNeighbor(Cell &cell) {
 	for (Position neighborPos : cell.getNeighborsPositions()) {
-		Cell &neighbor = *find(neighborPos);
-		find(neighbor.getPosition())->addNeighborPosition(cell.getPosition());
+		find(neighborPos)->addNeighborPosition(cell.getPosition());
 	}
-}
-
-template<typename Key, typename T, typename HashFunctionObject> typename HashTable<Key, T, HashFunctionObject>::reference HashTable<Key, T, HashFunctionObject>::iterator::operator*() {
-	return base[index];
-}
-
-template<typename Key, typename T, typename HashFunctionObject> typename const HashTable<Key, T, HashFunctionObject>::const_reference HashTable<Key, T, HashFunctionObject>::const_iterator::operator*() {
-	return base[index];
-}
-
-template<typename Key, typename T, typename HashFunctionObject> typename HashTable<Key, T, HashFunctionObject>::value_type *HashTable<Key, T, HashFunctionObject>::iterator::operator->() {
-	return &base[index];
-}
-
-template<typename Key, typename T, typename HashFunctionObject> typename const HashTable<Key, T, HashFunctionObject>::value_type *HashTable<Key, T, HashFunctionObject>::const_iterator::operator->() {
-	return &base[index];
 }
\ No newline at end of file
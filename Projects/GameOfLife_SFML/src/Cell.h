@@ -1,61 +1,82 @@
 #ifndef CELL_H
 #define CELL_H
 
+#include "Position.h"
 #include "Parser.h"
-#include "Window.h"
-#include "HashTable.h"
-
-#include <SFML/Graphics.hpp>
+#include "RuleKernels.h"
+#include "Torus.h"
+#include "CycleDetection.h"
+#include "Statistics.h"
+#include "MemoryAccounting.h"
+#include "PoolAllocator.h"
+#include "Autosave.h"
+#include "ChangeListener.h"
 
 #include <unordered_map>
+#include <vector>
 #include <string>
 #include <iostream>
 #include <functional>
 #include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <chrono>
 #include <type_traits>
 #include <limits>
 #include <algorithm>
+#include <memory>
+#include <array>
+#include <stdexcept>
+
+class Cells;
 
-class Position {
+class NeighborPositions { //The positions of the (at most 8) neighbors of a cell. Stored inside the cell, so creating a cell takes a single allocation.
 public:
-	typedef int coordType; //Signed integer.
+	typedef std::size_t size_type;
+	typedef const Position *const_iterator;
 
-	Position(coordType x, coordType y) : x{ x }, y{ y } {}
-	Position(sf::Vector2f v2f) : x{ coordType(v2f.x) }, y{ coordType(v2f.y) } {}
-	Position() = default;
+	static constexpr size_type capacity = 8;
 
-	friend bool operator==(const Position &pos1, const Position &pos2) {
-		return pos1.x == pos2.x && pos1.y == pos2.y;
+	void push_back(Position pos) {
+		if (count == capacity)
+			throw(std::logic_error("A cell cannot have more than 8 neighbors."));
+		positions[count++] = pos;
 	}
-	friend bool operator!=(const Position &pos1, const Position &pos2) {
-		return pos1.x != pos2.x && pos1.y != pos2.y;
-	}
-	friend Position operator+(const Position &pos1, const Position &pos2) {
-		return Position{ pos1.x + pos2.x, pos1.y + pos2.y };
+
+	void erase(const_iterator cIt) { //Keeps the order of the remaining neighbors.
+		std::copy(cIt + 1, cend(), positions.begin() + (cIt - cbegin()));
+		--count;
 	}
-	friend Position operator-(const Position &pos1, const Position &pos2) {
-		return Position{ pos1.x - pos2.x, pos1.y - pos2.y };
+
+	void clear() noexcept {
+		count = 0;
 	}
 
-	coordType x = { 0 }, y = { 0 };
-};
+	size_type size() const noexcept {
+		return count;
+	}
 
-class PositionHasher { //I know next to nothing about hash functions.
-public:
-	std::size_t operator()(const Position &pos) const { //https://stackoverflow.com/questions/2590677/how-do-i-combine-hash-values-in-c0x
-		auto hash1 = std::hash<Position::coordType>{}(pos.x), hash2 = std::hash<Position::coordType>{}(pos.y);
-		hash1 ^= hash2 + 0x9e3779b97f4a7c16 + (hash1 << 6) + (hash2 >> 2);
-		return hash1;
+	const_iterator begin() const noexcept {
+		return positions.data();
+	}
+	const_iterator cbegin() const noexcept {
+		return positions.data();
+	}
+	const_iterator end() const noexcept {
+		return positions.data() + count;
+	}
+	const_iterator cend() const noexcept {
+		return positions.data() + count;
 	}
-};
 
-class Cells;
+private:
+	std::array<Position, capacity> positions;
+	unsigned char count{ 0 };
+};
 
 class Cell {
 public:
-	typedef std::vector<Position> neighborPositionType;
+	typedef NeighborPositions neighborPositionType;
 
 	Cell(Position pos, bool a) : position{ pos }, alive{ a }, futureAlive{ a } {}
 	Cell() = default;
@@ -105,8 +126,6 @@ public:
 		neighborsPositions.erase(cIt);
 	}
 
-	static sf::Vector2f size;
-
 private:
 	neighborPositionType neighborsPositions;
 	Position position;
@@ -114,26 +133,63 @@ private:
 	bool alive;
 };
 
-class Cells { //Represents all cells. Cells are stored in an associative container so as to facilitate the adding of neighbors.
+class Cells { //Represents all cells. Cells are stored in an associative container so as to facilitate the adding of neighbors. The cells and statistics are allocated from pools of the thread that creates the world (see FixedSizePool), so a world must be used and destroyed on that thread.
 public:
 	typedef std::size_t size_type;
 	typedef Cell value_type;
 	typedef Cell &reference;
 	typedef const Cell &const_reference;
+	typedef CycleDetector::generationType generationType;
+	typedef std::vector<std::pair<Position, bool>, TaggedAllocator<std::pair<Position, bool>, MemoryAccounting::history>> changeContainerType; //Positions of cells that were born (true) or died (false).
 private:
+	class ChangeArena { //Append-only list of changes, stored in fixed-size chunks. Chunks are kept when the list shrinks, so recording rarely allocates and never copies old changes.
+	public:
+		typedef changeContainerType::value_type value_type;
+		typedef std::size_t size_type;
+
+		static constexpr size_type chunkSize = 16384;
+
+		void push_back(const value_type &change);
+		void truncate(size_type newSize); //Forget every change from index newSize onwards.
+
+		const value_type &operator[](size_type index) const {
+			return chunks[index / chunkSize][index % chunkSize];
+		}
+
+		size_type size() const noexcept {
+			return changeCount;
+		}
+
+	private:
+		std::vector<changeContainerType, TaggedAllocator<changeContainerType, MemoryAccounting::history>> chunks; //Every chunk but the last in use is full.
+		size_type changeCount{ 0 };
+	};
+
 	class CellsHistory { //Used in the storing of history. Stores the changes made to all cells in each update. We can then loop through those changes to look through history.
 	public:
 		CellsHistory &operator=(CellsHistory&) = delete;
 		CellsHistory &operator=(CellsHistory&&) = delete; //Pointer is passed to constructor, so delete.
 
 		CellsHistory(Cells *ptrCells) : associatedCells{ ptrCells } {
-			cellsChangeContainer.emplace_back();
+			tickBegins.push_back(0);
+			editEntries.push_back(false);
 		}
 
 		void appendChange(Cell &cell);
+		void appendChange(Position pos, bool alive);
 		void next(); //Continues and prepares for the next tick. Called at the beginning of each tick to signify the start of a new part of the history of the cells.
 		void last(); //Allows for the retrieval of history.
 		void removeFuture(); //Remove all history past the current part of history associated with currentIndex.
+		void clear(); //Forget all history. Used when the world changes in a way that cannot be rewound.
+		void beginEdit(); //Start an entry for cells changed by hand. Removes the future. Stepping back over it does not change the generation.
+
+		void setRecording(bool r) {
+			recording = r;
+		}
+
+		bool getRecording() const noexcept {
+			return recording;
+		}
 
 		void setLookingThroughHistory(bool lth);
 
@@ -142,15 +198,18 @@ private:
 		}
 
 	private:
-		typedef std::vector<std::vector<std::pair<Position, bool>>> cellsChangeContainerType; //Stores the changes in life of cells to minimalise memory usage. (Instead of storing all cells of each iteration.)
+		typedef std::vector<ChangeArena::size_type, TaggedAllocator<ChangeArena::size_type, MemoryAccounting::history>> tickBeginsContainerType;
 
-		cellsChangeContainerType cellsChangeContainer;
+		ChangeArena changes; //Stores the changes in life of cells to minimalise memory usage. (Instead of storing all cells of each iteration.)
+		tickBeginsContainerType tickBegins; //Index of the first change of each tick. The changes of a tick end where those of the next one begin.
+		std::vector<bool, TaggedAllocator<bool, MemoryAccounting::history>> editEntries; //Whether each entry holds edits instead of a tick.
 		Cells *associatedCells;
-		cellsChangeContainerType::size_type currentIndex{ 0 };
+		tickBeginsContainerType::size_type currentIndex{ 0 };
 		bool lookingThroughHistory{ true };
+		bool recording{ true }; //Batch runs turn this off, as history grows with every tick.
 	};
 
-	typedef std::unordered_map<Position, Cell, PositionHasher> cellsContainerType;
+	typedef std::unordered_map<Position, Cell, CellsHasher, std::equal_to<Position>, PoolAllocator<std::pair<const Position, Cell>, MemoryAccounting::cells>> cellsContainerType;
 	typedef CellsHistory historyType;
 
 	class iterator {
@@ -177,13 +236,6 @@ private:
 		iterator operator++(int) {
 			return iterator(baseIterator++);
 		}
-		iterator &operator--() {
-			--baseIterator;
-			return *this;
-		}
-		iterator operator--(int) {
-			return iterator(baseIterator--);
-		}
 
 	private:
 		cellsContainerType::iterator baseIterator;
@@ -213,13 +265,6 @@ private:
 		const_iterator operator++(int) {
 			return const_iterator(baseIterator++);
 		}
-		const_iterator &operator--() {
-			--baseIterator;
-			return *this;
-		}
-		const_iterator operator--(int) {
-			return const_iterator(baseIterator--);
-		}
 
 	private:
 		cellsContainerType::const_iterator baseIterator;
@@ -229,14 +274,29 @@ private:
 
 public:
 	Cells() : history{ this } {}
+	~Cells(); //The last autosave is written with the generation reached.
 
-	void update();
+	bool update(); //Tick or step back in history if it is time to. Returns true if the world changed.
+	std::chrono::steady_clock::time_point getNextUpdateTime() const; //When update next has something to do: a tick, a step of rewinding or an autosave. time_point::max() if nothing happens until the user does something.
 	void updateCells();
-	void render(Window &window) const;
+	void updateInfiniteCells(); //The part of updateCells used if the world is not bounded.
+	void setAutosave(const std::string &filePath, std::chrono::seconds interval); //Write the world to filePath every interval, from a background thread, with the generation, the position of the cells and the rules in a state file next to it. An empty filePath disables it.
+
+	void autosaveIfDue() { //Called once per frame, or per tick without a window.
+		if (autosave) {
+			autosave->setGeneration(generation);
+			autosave->saveIfDue();
+		}
+	}
+
+	void addChangeListener(ChangeListener &listener); //Report every alive cell to listener, and from then on every change. listener is not owned.
+	void removeChangeListener(ChangeListener &listener);
+
 	void expandIfNecessary(Cell &cell);
 	void addEmptyNeighborToCellsIfPossible(Position pos);
 
 	void stepBackInHistory() {
+		throwIfJumping("step back in history");
 		history.last();
 	}
 
@@ -256,14 +316,29 @@ public:
 		return rules;
 	}
 
-	cellsContainerType::size_type size() {
+	cellsContainerType::size_type size() const {
 		return cellsContainer.size();
 	}
 
+	cellsContainerType::size_type getBucketCount() const {
+		return cellsContainer.bucket_count();
+	}
+
+	float getLoadFactor() const {
+		return cellsContainer.load_factor();
+	}
+
 	void setRules(std::string str) {
 		Parser parser;
 		parser(str);
 		rules = parser;
+		rulesText = std::move(str);
+		if (autosave)
+			autosave->setRules(rulesText);
+	}
+
+	const std::string &getRulesText() const noexcept { //As given to setRules.
+		return rulesText;
 	}
 
 	void setRewind(bool r) {
@@ -283,6 +358,8 @@ public:
 	}
 
 	void setPause(bool p) {
+		if (!p)
+			throwIfJumping("resume");
 		pause = p;
 	}
 
@@ -306,22 +383,133 @@ public:
 		history.appendChange(cell);
 	}
 
+	void setWrapAround(Position::coordType width, Position::coordType height); //Move all cells into a bounded world of the given size whose edges wrap around.
+
+	bool getWrapAround() const noexcept {
+		return torus != nullptr;
+	}
+
+	void restoreCell(Position pos, bool alive); //Set the state of a cell without recording it in history. Used when looking through history.
+
+	generationType getGeneration() const noexcept {
+		return generation;
+	}
+
+	void setGeneration(generationType g); //Of a world resumed from an autosave. Clears history, whose generations were never simulated here.
+	const WorldStatistics &getStatistics() const noexcept {
+		return statistics;
+	}
+
+	const changeContainerType &getLastChanges() const noexcept { //The cells changed by the last call to updateCells.
+		return lastChanges;
+	}
+
+	std::uint64_t getChangeCount() const noexcept { //Increases whenever a cell is born or dies, or the world is recounted, so a copy of the world is up to date as long as it has not changed.
+		return changeCount;
+	}
+
+	const TorusGrid *getTorus() const noexcept { //nullptr unless the world wraps around.
+		return torus.get();
+	}
+
+	void setRecordHistory(bool r) {
+		history.setRecording(r);
+	}
+
+	void setCycleDetection(bool enabled); //Hash the world after each tick to notice when it starts repeating itself.
+
+	const CycleDetector *getCycleDetector() const noexcept { //nullptr if cycle detection is disabled.
+		return cycleDetector.get();
+	}
+
+	void setPauseOnCycle(bool p) { //Pause the first time a cycle is detected. Requires cycle detection.
+		pauseOnCycle = p;
+	}
+
+	bool skipCycles(generationType targetGeneration); //Once a cycle is detected, jump ahead by whole periods towards targetGeneration without simulating them. Returns true if generations were skipped. Throws std::overflow_error instead of skipping if the cells of an infinite world would move beyond what Position::coordType can hold.
+
+	class JumpReport {
+	public:
+		generationType from{ 0 }, to{ 0 };
+		std::chrono::nanoseconds timeTaken{ 0 };
+		bool skippedCycles{ false };
+		bool cancelled{ false };
+		std::string error; //Why the jump stopped before reaching its target, if it failed.
+	};
+
+	static constexpr unsigned maxStepExponent = 62; //For stepPowerOfTwo, so the generation cannot overflow.
+
+	void beginJump(generationType targetGeneration); //Start simulating up to targetGeneration as fast as possible: the generations in between are not drawn or recorded in history, and repeat by whole cycles once one is found. Clears history and pauses. update continues the jump in slices until it is finished. Throws std::invalid_argument if targetGeneration is in the past.
+	bool continueJump(std::chrono::nanoseconds timeLimit); //Simulate the jump for about timeLimit. Returns true once it is finished, or if there is none. If it fails, it is finished at the generation reached and the exception is rethrown.
+	void cancelJump(); //Stop the jump at the generation reached.
+	JumpReport jumpTo(generationType targetGeneration); //beginJump, and continue until the jump is finished.
+	generationType getStepTarget(unsigned exponent) const; //The generation 2^exponent generations ahead. Throws std::invalid_argument if it does not exist.
+	JumpReport stepPowerOfTwo(unsigned exponent); //jumpTo getStepTarget(exponent).
+
+	bool getJumping() const noexcept {
+		return jump != nullptr;
+	}
+
+	generationType getJumpTarget() const noexcept { //Only meaningful while jumping.
+		return jump ? jump->target : generation;
+	}
+
+	const JumpReport &getLastJump() const noexcept { //All zero if there was none.
+		return lastJump;
+	}
+
+	void translate(Position offset); //Move every alive cell. Clears history.
+
+	bool getAlive(Position pos) const; //Positions outside a world that wraps around are wrapped.
+
+	void applyEdits(changeContainerType &edits); //Set each position to the given state, as a single history entry. Meant for editing while paused. Reorders edits. Like stepBackInHistory and resuming with setPause(false), throws std::logic_error while a jump is in progress.
+
+	void setZOrder(bool zOrder); //Key cells by their Z-order (Morton) index and periodically lay them out in memory in that order, so cells that are close together are close together in memory.
+
+	bool getZOrder() const noexcept {
+		return cellsContainer.hash_function().getZOrder();
+	}
+
+	template<typename F> void forEachAliveCell(F f) const { //Calls f(Position) for every alive cell, regardless of how the world is stored.
+		if (torus)
+			torus->forEachAlive(f);
+		else {
+			for (auto &pair : cellsContainer) {
+				if (pair.second.getAlive())
+					f(pair.first);
+			}
+		}
+	}
+
 	Cell &insert(std::pair<Position, Cell> pair) {
-		return cellsContainer.emplace(pair).first->second;
+		auto result = cellsContainer.emplace(pair);
+		if (result.second && result.first->second.getAlive())
+			onCellChanged(pair.first, true);
+		return result.first->second;
 	}
 
 	void performMaintenance();
 
+	void relayout(); //Reinsert all cells in Z-order into memory blocks sorted by address.
+
 	void removeCell(Cell &cell); //Remove cell and remove cell from neighbors' neighbors container.
 
 	void addNeighborsToAllCells();
 
+	void bulkInsert(const changeContainerType &newCells); //Fill an empty world, together with the dead cells around the alive ones, and connect every cell to its neighbors without looking any of them up. Much faster than insert followed by addNeighborsToAllCells, but meant for maps, whose cells fill most of their bounding box. Cells spread more thinly than one per maxIndexedPositionsPerCell positions of their bounding box are inserted one by one instead.
+
 	void addNeighbors(Cell &cell);
 
 	void addNeighborToCellIfPossible(Cell &cell, Position pos);
 
 	void addAsNeighborToEachNeighbor(Cell &cell);
 
+	void connectNewCells(); //Neighbor fix-up for the cells applyEdits inserted.
+
+	void onCellChanged(Position pos, bool alive); //Called for every cell that is born or dies, including changes made by looking through history.
+
+	void recount(); //Recompute everything onCellChanged maintains from scratch.
+
 	auto begin() {
 		return iterator(cellsContainer.begin());
 	}
@@ -335,19 +523,55 @@ public:
 		return const_iterator(cellsContainer.cend());
 	}
 
+	static constexpr generationType maintenanceInterval = 64; //Generations between maintenance in runs without a window, which do not keep track of time.
+
 private:
 	static constexpr std::chrono::seconds maintenanceTime{ 2 };
+	static constexpr std::size_t maxIndexedPositionsPerCell = 8; //Of the bounding box indexed by bulkInsert.
+	static constexpr std::chrono::milliseconds jumpSliceTime{ 20 }; //Time update spends on a jump before returning, so the window is redrawn between slices.
+
+	class Jump { //A jump in progress, and what it detached from the world until it is finished.
+	public:
+		generationType target{ 0 };
+		JumpReport report;
+		decltype(std::chrono::steady_clock::now()) start;
+		std::vector<ChangeListener *> detachedChangeListeners;
+		std::unique_ptr<Autosave> detachedAutosave;
+		bool recording{ false }, detectingCycles{ false };
+	};
+
+	void finishJump(); //Reattach everything and report the jump.
+
+	void throwIfJumping(const char *action) const { //For what would act on a world that is halfway through a jump, and has its listeners and history detached.
+		if (jump)
+			throw(std::logic_error(std::string("Cannot ") + action + " while a jump is in progress."));
+	}
 
 	cellsContainerType cellsContainer;
 	historyType history;
+	std::unique_ptr<TorusGrid> torus; //Used instead of cellsContainer if the edges wrap around.
+	std::unique_ptr<CycleDetector> cycleDetector;
+	std::unique_ptr<Autosave> autosave;
+	std::vector<ChangeListener *> changeListeners;
+	WorldHash worldHash; //Only maintained if cycle detection is enabled.
+	WorldStatistics statistics;
+	generationType generation{ 0 };
 	Parser rules;
-	mutable std::vector<sf::Vertex> vertices; //Used in rendering.
+	std::string rulesText;
+	std::vector<Cell *> cellsToExpand; //Used in updateCells.
+	std::vector<Cell> relayoutBuffer; //Used in relayout.
+	std::vector<Cell *> newCells; //Used in applyEdits. In Z-order.
+	changeContainerType lastChanges;
 	decltype(std::chrono::steady_clock::now()) tickStartTime{ std::chrono::steady_clock::now() };
 	std::chrono::nanoseconds timePassedSinceLastTick{ 0 };
 	std::chrono::nanoseconds timePassedSinceLastMaintenance{ 0 };
 	std::chrono::milliseconds tickAimTime{ 1000 }, tickRewindAimTime{ 1000 };
 	bool pause = false;
 	bool rewinding = false;
+	bool pauseOnCycle = false;
+	JumpReport lastJump;
+	std::unique_ptr<Jump> jump; //nullptr unless jumping.
+	std::uint64_t changeCount{ 0 };
 };
 
 Cell::neighborPositionType::size_type aliveNeighborCount(const Cell &cell, Cells &cells);
@@ -0,0 +1,61 @@
+#include "CellRenderer.h"
+#include "Cell.h"
+#include "TileCache.h"
+#include "Window.h"
+#include "Profiler.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <memory>
+
+sf::Vector2f CellRenderer::cellSize(60, 60);
+
+CellRenderer::~CellRenderer() {
+	setTileCache(false);
+}
+
+void CellRenderer::render(Window &window) {
+	PROFILE_SCOPE(renderingCells);
+
+	window.updateCameraOrigin(cellSize);
+	window.getSFMLWindow().setView(window.getView());
+
+	if (tileCache) {
+		const sf::View &view = window.getView();
+		sf::FloatRect visibleArea(view.getCenter() - view.getSize() / 2.f, view.getSize());
+		tileCache->render(window.getSFMLWindow(), visibleArea, cellSize, window.getCameraOrigin());
+		return;
+	}
+
+	buildVertices(window.getCameraOrigin());
+
+	window.getSFMLWindow().draw(vertices.data(), vertices.size(), sf::Quads);
+}
+
+void CellRenderer::setTileCache(bool enabled) {
+	if (tileCache)
+		cells->removeChangeListener(*tileCache);
+
+	if (enabled) {
+		tileCache = std::make_unique<TileCache>();
+		cells->addChangeListener(*tileCache);
+	}
+	else
+		tileCache = nullptr;
+}
+
+void CellRenderer::buildVertices(Position cameraOrigin) {
+	vertices.clear();
+
+	auto addAliveCell = [this, cameraOrigin](Position pos) {
+		pos = pos - cameraOrigin; //Small, so it converts to float exactly.
+		const sf::Vector2f finalBegPos(static_cast<float>(pos.x) * cellSize.x, static_cast<float>(pos.y) * cellSize.y);
+
+		vertices.emplace_back(sf::Vector2f(finalBegPos.x, finalBegPos.y), sf::Color::Green);
+		vertices.emplace_back(sf::Vector2f(finalBegPos.x + cellSize.x, finalBegPos.y), sf::Color::Green);
+		vertices.emplace_back(sf::Vector2f(finalBegPos.x + cellSize.x, finalBegPos.y + cellSize.y), sf::Color::Green);
+		vertices.emplace_back(sf::Vector2f(finalBegPos.x, finalBegPos.y + cellSize.y), sf::Color::Green);
+	};
+
+	cells->forEachAliveCell(addAliveCell);
+}
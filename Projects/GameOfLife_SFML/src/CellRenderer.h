@@ -0,0 +1,46 @@
+#ifndef CELLRENDERER_H
+#define CELLRENDERER_H
+
+#include "Cell.h"
+#include "Position.h"
+#include "TileCache.h"
+#include "Window.h"
+#include "MemoryAccounting.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+#include <memory>
+
+class CellRenderer { //Draws the alive cells of a world into a window: through cached tiles that follow the changes of the world, or as one quad per alive cell, built every frame.
+public:
+	typedef std::vector<sf::Vertex, TaggedAllocator<sf::Vertex, MemoryAccounting::rendering>> vertexContainerType;
+
+	static sf::Vector2f cellSize; //In view coordinates.
+
+	CellRenderer(Cells &c) : cells{ &c } {}
+	~CellRenderer();
+
+	CellRenderer(const CellRenderer &) = delete;
+	CellRenderer &operator=(const CellRenderer &) = delete;
+
+	void render(Window &window);
+	void buildVertices(Position cameraOrigin = Position{ 0, 0 }); //The part of render that does not need a window: one quad per alive cell, relative to cameraOrigin. Used if the tile cache is disabled.
+
+	void setTileCache(bool enabled); //Render through cached tiles that are only redrawn where cells changed.
+
+	const TileCache *getTileCache() const noexcept { //nullptr if disabled.
+		return tileCache.get();
+	}
+
+	const vertexContainerType &getVertices() const noexcept {
+		return vertices;
+	}
+
+private:
+	Cells *cells;
+	std::unique_ptr<TileCache> tileCache;
+	vertexContainerType vertices;
+};
+
+#endif
\ No newline at end of file
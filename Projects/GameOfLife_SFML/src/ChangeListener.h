@@ -0,0 +1,15 @@
+#ifndef CHANGELISTENER_H
+#define CHANGELISTENER_H
+
+#include "Position.h"
+
+class ChangeListener { //Something outside of the simulation that follows every cell that is born or dies, such as the tiles drawn by a window. Added to Cells, which does not own it.
+public:
+	virtual ~ChangeListener() = default;
+
+	virtual void update(Position pos, bool alive) = 0; //Called for each cell that was born or died.
+	virtual void clear() = 0; //The world is about to be reported again from scratch, through update.
+	virtual void maintain() {} //Called with the periodic maintenance of the world, to drop what is no longer needed.
+};
+
+#endif
\ No newline at end of file
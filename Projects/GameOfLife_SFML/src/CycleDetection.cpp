@@ -0,0 +1,140 @@
+#include "CycleDetection.h"
+
+#include <cstdint>
+#include <array>
+#include <type_traits>
+
+namespace {
+	//Arithmetic modulo the Mersenne prime 2^61 - 1, without relying on 128 bit integers.
+	constexpr std::uint64_t modulus = (std::uint64_t(1) << 61) - 1;
+	constexpr std::uint64_t baseX = 0x1f3d5b79a2c4e681 % modulus, baseY = 0x2b7e151628aed2a6 % modulus; //Arbitrary.
+	constexpr std::uint64_t exponentOffset = std::uint64_t(1) << 31; //Makes the exponent of any coordinate positive. Only multiplies the hash by a constant, so translations still work.
+
+	std::uint64_t reduce(std::uint64_t x) {
+		x = (x & modulus) + (x >> 61);
+		return x >= modulus ? x - modulus : x;
+	}
+
+	std::uint64_t mulMod(std::uint64_t a, std::uint64_t b) { //Split both factors into 31/30 bit halves so no partial product overflows.
+		constexpr std::uint64_t mask31 = (std::uint64_t(1) << 31) - 1, mask30 = (std::uint64_t(1) << 30) - 1;
+
+		std::uint64_t aHigh = a >> 31, aLow = a & mask31, bHigh = b >> 31, bLow = b & mask31;
+		std::uint64_t middle = aLow * bHigh + aHigh * bLow;
+		std::uint64_t middleHigh = middle >> 30, middleLow = middle & mask30;
+
+		return reduce(aHigh * bHigh * 2 + middleHigh + (middleLow << 31) + aLow * bLow);
+	}
+
+	std::uint64_t powMod(std::uint64_t base, std::uint64_t exponent) {
+		std::uint64_t result = 1;
+		for (; exponent; exponent >>= 1) {
+			if (exponent & 1)
+				result = mulMod(result, base);
+			base = mulMod(base, base);
+		}
+		return result;
+	}
+
+	std::uint64_t powSigned(std::uint64_t base, std::int64_t exponent) { //Negative exponents use the inverse of base. (Fermat's little theorem)
+		if (exponent >= 0)
+			return powMod(base, std::uint64_t(exponent));
+		return powMod(powMod(base, modulus - 2), std::uint64_t(-exponent));
+	}
+
+	typedef std::conditional_t<sizeof(Position::coordType) <= 4, std::uint32_t, std::uint64_t> exponentType;
+
+	class PowerTable { //base^e for any exponent, using one lookup per 16 bits of the exponent instead of a full exponentiation per cell.
+	public:
+		static constexpr std::size_t levels = sizeof(exponentType) / 2; //Exponents of 64 bit coordinates are below 2^61, so the last level is only partly used.
+
+		PowerTable(std::uint64_t base) {
+			for (std::size_t level = 0; level < levels; ++level) {
+				std::uint64_t power = 1;
+				for (std::size_t i = 0; i < 1 << 16; ++i) {
+					powers[level][i] = power;
+					power = mulMod(power, base);
+				}
+				base = power; //base^(2^16), the step of the next level.
+			}
+		}
+
+		std::uint64_t operator()(exponentType exponent) const {
+			std::uint64_t result = powers[0][exponent & 0xffff];
+			for (std::size_t level = 1; level < levels; ++level)
+				result = mulMod(result, powers[level][(exponent >> (16 * level)) & 0xffff]);
+			return result;
+		}
+
+	private:
+		std::array<std::array<std::uint64_t, 1 << 16>, levels> powers;
+	};
+
+	exponentType toExponent(Position::coordType coord) {
+		if constexpr (sizeof(Position::coordType) <= 4)
+			return static_cast<exponentType>(std::int64_t(coord) + exponentOffset);
+		else { //Exponents only matter modulo modulus - 1, the order of the group. (Fermat's little theorem)
+			constexpr std::int64_t order = std::int64_t(modulus - 1);
+			std::int64_t exponent = coord % order;
+			return static_cast<exponentType>((exponent < 0 ? exponent + order : exponent) + exponentOffset) % (modulus - 1);
+		}
+	}
+
+	std::uint64_t cellHash(Position pos) {
+		static const PowerTable powersX(baseX), powersY(baseY);
+		return mulMod(powersX(toExponent(pos.x)), powersY(toExponent(pos.y)));
+	}
+}
+
+void WorldHash::update(Position pos, bool alive) {
+	std::uint64_t h = cellHash(pos);
+	hash = alive ? reduce(hash + h) : reduce(hash + modulus - h);
+}
+
+void WorldHash::clear() {
+	hash = 0;
+}
+
+void WorldHash::add(const WorldHash &other) {
+	hash = reduce(hash + other.hash);
+}
+
+WorldHash::hashType WorldHash::getNormalizedHash(Position boundingBoxMin) const { //Moving every cell by (dx, dy) multiplies the hash by a^dx * b^dy.
+	return mulMod(mulMod(hash, powSigned(baseX, -std::int64_t(boundingBoxMin.x))), powSigned(baseY, -std::int64_t(boundingBoxMin.y)));
+}
+
+bool CycleDetector::record(generationType generation, const WorldHash &worldHash, Position boundingBoxMin, bool allowDisplacement) {
+	Record current;
+	current.generation = generation;
+	current.hash = worldHash.getHash();
+	current.normalizedHash = worldHash.getNormalizedHash(boundingBoxMin);
+	current.boundingBoxMin = boundingBoxMin;
+	current.used = true;
+
+	//Search from the most recent generation backwards, so the shortest period is found.
+	for (std::size_t i = 1; i <= records.size(); ++i) {
+		const Record &old = records[(nextRecord + records.size() - i) % records.size()];
+		if (!old.used || old.generation >= generation)
+			break;
+
+		bool sameWorld = old.hash == current.hash;
+		bool translatedWorld = allowDisplacement && old.normalizedHash == current.normalizedHash;
+		if (sameWorld || translatedWorld) {
+			cycle.period = generation - old.generation;
+			cycle.detectedAt = generation;
+			cycle.displacement = sameWorld ? Position{ 0, 0 } : current.boundingBoxMin - old.boundingBoxMin;
+			break;
+		}
+	}
+
+	records[nextRecord] = current;
+	nextRecord = (nextRecord + 1) % records.size();
+
+	return found();
+}
+
+void CycleDetector::clear() {
+	for (Record &record : records)
+		record.used = false;
+	nextRecord = 0;
+	cycle = Cycle();
+}
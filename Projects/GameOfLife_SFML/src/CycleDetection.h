@@ -0,0 +1,66 @@
+#ifndef CYCLEDETECTION_H
+#define CYCLEDETECTION_H
+
+#include "Position.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class WorldHash { //Hash of all alive cells: the sum of a^x * b^y over every alive cell, modulo the prime 2^61 - 1.
+public:
+	typedef std::uint64_t hashType;
+
+	void update(Position pos, bool alive); //Called for each cell that was born (alive) or died (!alive).
+	void clear();
+	void add(const WorldHash &other); //Becomes the hash of both worlds together. They must not share any alive cell.
+
+	hashType getHash() const noexcept {
+		return hash;
+	}
+
+	hashType getNormalizedHash(Position boundingBoxMin) const; //The hash of the world moved so that the top left corner of its bounding box is at (0, 0). Equal for translated copies of the same world.
+
+private:
+	hashType hash{ 0 };
+};
+
+class CycleDetector { //Remembers the hashes of recent generations to find worlds that repeat themselves, possibly at another position.
+public:
+	typedef unsigned long long generationType;
+
+	class Cycle {
+	public:
+		generationType period{ 0 }; //0 if no cycle was found.
+		generationType detectedAt{ 0 }; //The generation in which the repetition was noticed.
+		Position displacement; //How far the world moves each period. (0, 0) for still lifes and oscillators.
+	};
+
+	CycleDetector(std::size_t maxPeriod = 1024) : records(maxPeriod) {}
+
+	bool record(generationType generation, const WorldHash &worldHash, Position boundingBoxMin, bool allowDisplacement); //Returns true if the world repeats a recorded generation.
+	void clear();
+
+	const Cycle &getCycle() const noexcept {
+		return cycle;
+	}
+
+	bool found() const noexcept {
+		return cycle.period != 0;
+	}
+
+private:
+	class Record {
+	public:
+		generationType generation{ 0 };
+		WorldHash::hashType hash{ 0 }, normalizedHash{ 0 };
+		Position boundingBoxMin;
+		bool used{ false };
+	};
+
+	std::vector<Record> records; //Ring buffer of the most recent generations.
+	std::size_t nextRecord{ 0 };
+	Cycle cycle;
+};
+
+#endif
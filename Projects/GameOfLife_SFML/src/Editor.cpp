@@ -0,0 +1,76 @@
+#include "Editor.h"
+#include "FileProcessing.h"
+#include "CellRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+void Editor::setPattern(const std::string &mapStr) {
+	pattern = getPatternFromStr(mapStr);
+}
+
+void Editor::onMousePressed(sf::Vector2i pixel, Window &window, Cells &cells) {
+	Position pos = getCellPosition(pixel, window);
+	message.clear();
+
+	switch (tool) {
+	case toggle:
+		edits.clear();
+		edits.emplace_back(pos, !cells.getAlive(pos));
+		cells.applyEdits(edits);
+		break;
+
+	case fill:
+	case clear:
+		dragStart = pos;
+		dragging = true;
+		break;
+
+	case paste:
+		edits.clear();
+		for (auto &change : pattern)
+			edits.emplace_back(change.first + pos, change.second);
+		cells.applyEdits(edits);
+		break;
+	}
+}
+
+void Editor::onMouseReleased(sf::Vector2i pixel, Window &window, Cells &cells) {
+	if (!dragging)
+		return;
+
+	dragging = false;
+	editRectangle(dragStart, getCellPosition(pixel, window), tool == fill, cells);
+}
+
+Position Editor::getCellPosition(sf::Vector2i pixel, Window &window) {
+	sf::Vector2f coords = window.getSFMLWindow().mapPixelToCoords(pixel, window.getView());
+	return window.getCameraOrigin() + Position{ static_cast<Position::coordType>(std::floor(coords.x / CellRenderer::cellSize.x)), static_cast<Position::coordType>(std::floor(coords.y / CellRenderer::cellSize.y)) };
+}
+
+void Editor::editRectangle(Position corner1, Position corner2, bool alive, Cells &cells) {
+	Position min{ std::min(corner1.x, corner2.x), std::min(corner1.y, corner2.y) };
+	Position max{ std::max(corner1.x, corner2.x), std::max(corner1.y, corner2.y) };
+
+	edits.clear();
+	if (alive) {
+		const std::uint64_t width = static_cast<std::uint64_t>(max.x) - static_cast<std::uint64_t>(min.x) + 1, height = static_cast<std::uint64_t>(max.y) - static_cast<std::uint64_t>(min.y) + 1;
+		if (width > maxFillArea || height > maxFillArea / width) {
+			message = "FILL TOO LARGE, AT MOST " + std::to_string(maxFillArea) + " CELLS";
+			return;
+		}
+
+		for (Position::coordType y = min.y; y <= max.y; ++y) {
+			for (Position::coordType x = min.x; x <= max.x; ++x)
+				edits.emplace_back(Position{ x, y }, true);
+		}
+	}
+	else { //Only alive cells can be killed, so there is no need to visit every position of a large rectangle.
+		cells.forEachAliveCell([&](Position pos) {
+			if (pos.x >= min.x && pos.x <= max.x && pos.y >= min.y && pos.y <= max.y)
+				edits.emplace_back(pos, false);
+		});
+	}
+
+	cells.applyEdits(edits);
+}
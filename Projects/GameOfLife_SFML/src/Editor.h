@@ -0,0 +1,55 @@
+#ifndef EDITOR_H
+#define EDITOR_H
+
+#include "Cell.h"
+#include "Window.h"
+
+#include <string>
+#include <cstdint>
+
+class Editor { //Mouse tools for changing cells while the simulation is paused. (Extension 6)
+public:
+	enum Tool {
+		toggle, //Click a cell to bring it to life or kill it.
+		fill, //Drag a rectangle to bring every cell in it to life.
+		clear, //Drag a rectangle to kill every cell in it.
+		paste //Click to place the pattern with its top left corner on the cell.
+	};
+
+	void setTool(Tool t) noexcept {
+		tool = t;
+	}
+
+	Tool getTool() const noexcept {
+		return tool;
+	}
+
+	void setPattern(const std::string &mapStr); //In the map file format.
+
+	void onMousePressed(sf::Vector2i pixel, Window &window, Cells &cells);
+	void onMouseReleased(sf::Vector2i pixel, Window &window, Cells &cells);
+
+	void cancelDrag() noexcept { //Forget the rectangle being dragged.
+		dragging = false;
+	}
+
+	const std::string &getMessage() const noexcept { //Why the last edit was refused, or empty.
+		return message;
+	}
+
+	static constexpr std::uint64_t maxFillArea = 1 << 20; //Cells a fill may bring to life at once. Each is an edit and a step of history.
+
+private:
+	static Position getCellPosition(sf::Vector2i pixel, Window &window); //The cell under a pixel of the window.
+
+	void editRectangle(Position corner1, Position corner2, bool alive, Cells &cells);
+
+	Cells::changeContainerType pattern;
+	Cells::changeContainerType edits; //Reused between edits.
+	std::string message;
+	Position dragStart;
+	bool dragging{ false };
+	Tool tool{ toggle };
+};
+
+#endif
\ No newline at end of file
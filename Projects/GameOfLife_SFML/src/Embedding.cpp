@@ -0,0 +1,146 @@
+#include "Embedding.h"
+#include "WorldView.h"
+#include "PopulationIndex.h"
+#include "Cell.h"
+#include "FileProcessing.h"
+
+#include <string>
+#include <exception>
+#include <type_traits>
+#include <cstddef>
+#include <thread>
+#include <stdexcept>
+
+static_assert(std::is_same<golCoord, Position::coordType>::value, "golCoord must match Position::coordType.");
+static_assert(std::is_standard_layout<Position>::value && sizeof(golPosition) == sizeof(Position) && offsetof(golPosition, y) == offsetof(Position, y), "golPosition must have the layout of Position, so alive cells can be handed out without copying them.");
+static_assert(std::is_same<TorusGrid::stateType, unsigned char>::value, "golGrid hands out the cells as unsigned char.");
+
+struct golWorld {
+	golWorld() : view{ cells } {}
+	~golWorld() {
+		if (populationIndex)
+			cells.removeChangeListener(*populationIndex);
+	}
+
+	PopulationIndex &getPopulationIndex() { //Only worlds that are queried pay for the index.
+		if (!populationIndex) {
+			populationIndex = std::make_unique<PopulationIndex>();
+			cells.addChangeListener(*populationIndex);
+		}
+		return *populationIndex;
+	}
+
+	Cells cells;
+	WorldView view;
+	std::unique_ptr<PopulationIndex> populationIndex;
+	const std::thread::id owner{ std::this_thread::get_id() }; //Cells are allocated from pools of the thread that creates the world, and must be freed on it.
+};
+
+namespace {
+	thread_local std::string lastError;
+
+	template<typename F> bool reportErrors(const golWorld *world, F f) { //Exceptions must not cross into C. world is nullptr while creating one.
+		try {
+			if (world && world->owner != std::this_thread::get_id())
+				throw(std::logic_error("A world can only be used on the thread that created it."));
+
+			f();
+			return true;
+		}
+		catch (const std::exception &e) {
+			lastError = e.what();
+		}
+		catch (...) {
+			lastError = "Unknown error.";
+		}
+		return false;
+	}
+}
+
+golWorld *golCreateWorld(const char *rules) {
+	golWorld *world = nullptr;
+	reportErrors(nullptr, [&] {
+		auto newWorld = std::make_unique<golWorld>();
+		newWorld->cells.setRules(rules);
+		newWorld->cells.setRecordHistory(false); //Nobody can rewind.
+		world = newWorld.release();
+	});
+	return world;
+}
+
+int golDestroyWorld(golWorld *world) {
+	return reportErrors(world, [&] {
+		delete world;
+	});
+}
+
+int golLoadMap(golWorld *world, const char *map, int wrapAround) {
+	return reportErrors(world, [&] {
+		loadMapFromStr(world->cells, map, wrapAround != 0);
+	});
+}
+
+int golStep(golWorld *world, uint64_t generations) {
+	return reportErrors(world, [&] {
+		for (uint64_t i = 0; i < generations; ++i) {
+			world->cells.updateCells();
+			if (world->cells.getGeneration() % Cells::maintenanceInterval == 0)
+				world->cells.performMaintenance();
+		}
+	});
+}
+
+uint64_t golGetGeneration(const golWorld *world) {
+	uint64_t generation = 0;
+	reportErrors(world, [&] {
+		generation = world->cells.getGeneration();
+	});
+	return generation;
+}
+
+size_t golGetPopulation(const golWorld *world) {
+	size_t population = 0;
+	reportErrors(world, [&] {
+		population = world->cells.getStatistics().getPopulation();
+	});
+	return population;
+}
+
+golAliveCells golGetAliveCells(golWorld *world) {
+	golAliveCells aliveCells{ nullptr, 0 };
+	reportErrors(world, [&] {
+		WorldView::AliveCells view = world->view.getAliveCells();
+		aliveCells.positions = reinterpret_cast<const golPosition *>(view.positions);
+		aliveCells.count = view.count;
+	});
+	return aliveCells;
+}
+
+golGrid golGetGrid(const golWorld *world) {
+	golGrid grid{ nullptr, 0, 0, 0 };
+	reportErrors(world, [&] {
+		WorldView::Grid view = world->view.getGrid();
+		grid = golGrid{ view.cells, view.width, view.height, view.stride };
+	});
+	return grid;
+}
+
+size_t golCountAlive(golWorld *world, golPosition min, golPosition max) {
+	size_t count = 0;
+	reportErrors(world, [&] {
+		count = world->getPopulationIndex().count(Position{ min.x, min.y }, Position{ max.x, max.y });
+	});
+	return count;
+}
+
+int golAnyAlive(golWorld *world, golPosition min, golPosition max) {
+	bool anyAlive = false;
+	reportErrors(world, [&] {
+		anyAlive = world->getPopulationIndex().anyAlive(Position{ min.x, min.y }, Position{ max.x, max.y });
+	});
+	return anyAlive;
+}
+
+const char *golGetLastError(void) {
+	return lastError.c_str();
+}
@@ -0,0 +1,60 @@
+#ifndef EMBEDDING_H
+#define EMBEDDING_H
+
+/*The simulation as a C library, for programs written in other languages. Nothing here needs C++ or SFML.
+A world is created from the text of a rules file, filled with the text of a map, and stepped. Its cells can then be read in place, without copying:
+golGetAliveCells returns the positions of all alive cells, and golGetGrid the cells of a world that wraps around, row by row.
+Both stay valid until the world changes, that is until the next golStep or golLoadMap, or golDestroyWorld.
+Functions that can fail return 0 (or NULL), and golGetLastError tells why.
+A world belongs to the thread that created it: its cells are allocated from pools of that thread, so every other function, golDestroyWorld included, fails when called on another thread.
+Different threads can each use their own worlds at the same time.*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef GOL_64BIT_COORDINATES
+typedef int64_t golCoord;
+#else
+typedef int32_t golCoord;
+#endif
+
+typedef struct golWorld golWorld;
+
+typedef struct golPosition {
+	golCoord x, y;
+} golPosition;
+
+typedef struct golAliveCells { //In no particular order.
+	const golPosition *positions;
+	size_t count;
+} golAliveCells;
+
+typedef struct golGrid { //One byte per cell, 1 if alive. cells is NULL if the world does not wrap around.
+	const unsigned char *cells;
+	golCoord width, height;
+	size_t stride; //Bytes from the start of one row to the start of the next.
+} golGrid;
+
+golWorld *golCreateWorld(const char *rules); //An empty, infinite world. History is not recorded.
+int golDestroyWorld(golWorld *world); //Fails, leaving the world as it is, on another thread than the one that created it.
+int golLoadMap(golWorld *world, const char *map, int wrapAround); //Fill an empty world. If wrapAround, the world becomes the size of the map and its edges wrap around.
+int golStep(golWorld *world, uint64_t generations);
+
+uint64_t golGetGeneration(const golWorld *world);
+size_t golGetPopulation(const golWorld *world);
+golAliveCells golGetAliveCells(golWorld *world); //Gathered again only if the world changed since the last call.
+golGrid golGetGrid(const golWorld *world);
+size_t golCountAlive(golWorld *world, golPosition min, golPosition max); //Alive cells with min.x <= x <= max.x and min.y <= y <= max.y, counted without visiting them. The first call indexes the world, which is kept up to date from then on.
+int golAnyAlive(golWorld *world, golPosition min, golPosition max); //1 if golCountAlive would not return 0.
+
+const char *golGetLastError(void); //Of the calling thread. Empty if nothing failed yet.
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
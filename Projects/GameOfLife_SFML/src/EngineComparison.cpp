@@ -0,0 +1,299 @@
+#include "EngineComparison.h"
+#include "Cell.h"
+#include "Parser.h"
+#include "FileProcessing.h"
+#include "SoupSearch.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <filesystem>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cstdint>
+
+namespace {
+	constexpr Cells::generationType defaultGenerations = 100; //Per case. Enough for most soups to settle, while rules that explode stay cheap.
+	constexpr std::uint64_t soupsPerRules = 4;
+	constexpr int soupSize = 16;
+	constexpr Position::coordType maxDumpWidth = 64, maxDumpHeight = 32; //Of the region printed around the first difference.
+
+	class ReferenceEngine : public Engine { //As plain as possible, and sharing no code with Cells: a set of alive cells, and the rules evaluated by walking the parse trees for every cell. Cells goes through the transition table built from the same trees, so a mistake in building it shows up as a difference.
+	public:
+		void load(const std::string &rulesStr, const cellContainerType &aliveCells) override {
+			parser = Parser();
+			parser(rulesStr);
+			alive = std::unordered_set<Position, PositionHasher>(aliveCells.begin(), aliveCells.end());
+		}
+
+		void step() override {
+			std::unordered_map<Position, int, PositionHasher> aliveNeighbors;
+			for (Position pos : alive) {
+				aliveNeighbors[pos]; //Alive cells without alive neighbors are evaluated too.
+				for (Position::coordType y = -1; y <= 1; ++y) {
+					for (Position::coordType x = -1; x <= 1; ++x) {
+						if (x || y)
+							++aliveNeighbors[pos + Position{ x, y }];
+					}
+				}
+			}
+
+			std::unordered_set<Position, PositionHasher> next;
+			for (auto &pair : aliveNeighbors) {
+				if (parser.getFuture(alive.count(pair.first) != 0, pair.second))
+					next.insert(pair.first);
+			}
+			alive.swap(next);
+		}
+
+		cellContainerType getAliveCells() const override {
+			return cellContainerType(alive.begin(), alive.end());
+		}
+
+	private:
+		std::unordered_set<Position, PositionHasher> alive;
+		Parser parser;
+	};
+
+	class CellsEngine : public Engine { //Cells::updateCells, loaded like a map file.
+	public:
+		CellsEngine(bool zO) : zOrder{ zO } {}
+
+		void load(const std::string &rulesStr, const cellContainerType &aliveCells) override {
+			cells.setRules(rulesStr);
+			cells.setRecordHistory(false);
+			cells.setZOrder(zOrder);
+			Cells::changeContainerType newCells;
+			for (Position pos : aliveCells)
+				newCells.emplace_back(pos, true);
+			cells.bulkInsert(newCells);
+		}
+
+		void step() override {
+			cells.updateCells();
+			if (cells.getGeneration() % Cells::maintenanceInterval == 0) //Maintenance is part of what is compared.
+				cells.performMaintenance();
+		}
+
+		cellContainerType getAliveCells() const override {
+			cellContainerType aliveCells;
+			cells.forEachAliveCell([&aliveCells](Position pos) {
+				aliveCells.push_back(pos);
+			});
+			return aliveCells;
+		}
+
+	private:
+		Cells cells;
+		bool zOrder;
+	};
+
+	class Case {
+	public:
+		std::string name;
+		std::string rulesStr;
+		Engine::cellContainerType aliveCells;
+	};
+
+	Engine::cellContainerType getAliveCellsFromStr(const std::string &mapStr) {
+		Engine::cellContainerType aliveCells;
+		for (auto &cell : getPatternFromStr(mapStr)) {
+			if (cell.second)
+				aliveCells.push_back(cell.first);
+		}
+		return aliveCells;
+	}
+
+	std::vector<std::filesystem::path> getTextFiles(const std::filesystem::path &directory) { //Sorted, so cases are always in the same order.
+		std::vector<std::filesystem::path> files;
+		if (std::filesystem::is_directory(directory)) {
+			for (auto &entry : std::filesystem::directory_iterator(directory)) {
+				if (entry.is_regular_file() && entry.path().extension() == ".txt")
+					files.push_back(entry.path());
+			}
+		}
+		std::sort(files.begin(), files.end());
+		return files;
+	}
+
+	std::vector<Case> getCases(const Options &options) { //Every map and soup under every rules file.
+		std::vector<std::filesystem::path> rulesFiles{ options.rulesFilePath }, mapFiles;
+		if (!options.mapFilePath.empty())
+			mapFiles.push_back(options.mapFilePath);
+		if (!options.corpusPath.empty()) {
+			std::filesystem::path corpus(options.corpusPath);
+			if (!std::filesystem::is_directory(corpus))
+				throw(std::invalid_argument("The corpus '" + options.corpusPath + "' is not a directory."));
+			for (auto &path : getTextFiles(corpus / "Rules"))
+				rulesFiles.push_back(path);
+			for (auto &path : getTextFiles(corpus / "Patterns"))
+				mapFiles.push_back(path);
+			if (std::filesystem::is_regular_file(corpus / "map.txt"))
+				mapFiles.push_back(corpus / "map.txt");
+		}
+
+		std::uint64_t firstSeed = options.seedGiven ? options.seed : 1; //Fixed, so golden files stay valid.
+
+		std::vector<Case> cases;
+		for (auto &rulesFile : rulesFiles) {
+			std::string rulesStr = readFile(rulesFile.string());
+			for (auto &mapFile : mapFiles)
+				cases.push_back(Case{ rulesFile.filename().string() + ", " + mapFile.filename().string(), rulesStr, getAliveCellsFromStr(readFile(mapFile.string())) });
+
+			if (!options.corpusPath.empty()) {
+				for (std::uint64_t seed = firstSeed; seed < firstSeed + soupsPerRules; ++seed) {
+					Case soup{ rulesFile.filename().string() + ", soup " + std::to_string(seed), rulesStr, {} };
+					for (auto &cell : generateSoup(seed, soupSize))
+						soup.aliveCells.push_back(cell.first);
+					cases.push_back(soup);
+				}
+			}
+		}
+
+		return cases;
+	}
+
+	void dumpDifference(std::ostream &os, const std::string &name1, const Engine::cellContainerType &cells1, const std::string &name2, const Engine::cellContainerType &cells2) {
+		std::unordered_set<Position, PositionHasher> alive1(cells1.begin(), cells1.end()), alive2(cells2.begin(), cells2.end());
+
+		Engine::cellContainerType differences;
+		for (Position pos : cells1) {
+			if (!alive2.count(pos))
+				differences.push_back(pos);
+		}
+		for (Position pos : cells2) {
+			if (!alive1.count(pos))
+				differences.push_back(pos);
+		}
+		std::sort(differences.begin(), differences.end(), [](Position pos1, Position pos2) {
+			return pos1.y < pos2.y || (pos1.y == pos2.y && pos1.x < pos2.x);
+		});
+
+		//Around the differences, but no larger than maxDumpWidth x maxDumpHeight, starting at the first one.
+		Position first = differences.front();
+		Position topLeft{ first.x, first.y - 2 }, bottomRight{ first.x, first.y };
+		for (Position pos : differences) {
+			if (pos.y - topLeft.y >= maxDumpHeight - 2)
+				break;
+			topLeft.x = std::min(topLeft.x, std::max(pos.x, first.x - maxDumpWidth / 2));
+			bottomRight.x = std::max(bottomRight.x, std::min(pos.x, first.x + maxDumpWidth / 2));
+			bottomRight.y = pos.y;
+		}
+		topLeft.x -= 2;
+		bottomRight = bottomRight + Position{ 2, 2 };
+
+		os << differences.size() << " cells differ. (" << topLeft.x << ", " << topLeft.y << ") to (" << bottomRight.x << ", " << bottomRight.y << "), as maps: " << name1 << " | " << name2 << " | X where they differ\n";
+		for (Position::coordType y = topLeft.y; y <= bottomRight.y; ++y) {
+			std::string row1, row2, differenceRow;
+			for (Position::coordType x = topLeft.x; x <= bottomRight.x; ++x) {
+				bool isAlive1 = alive1.count(Position{ x, y }) != 0, isAlive2 = alive2.count(Position{ x, y }) != 0;
+				row1 += isAlive1 ? '*' : '#';
+				row2 += isAlive2 ? '*' : '#';
+				differenceRow += isAlive1 != isAlive2 ? 'X' : ' ';
+			}
+			os << row1 << " | " << row2 << " | " << differenceRow << "\n";
+		}
+	}
+
+	std::string toHex(WorldHash::hashType hash) {
+		std::ostringstream hex;
+		hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+		return hex.str();
+	}
+}
+
+WorldHash Engine::getWorldHash() const {
+	WorldHash worldHash;
+	for (Position pos : getAliveCells())
+		worldHash.update(pos, true);
+	return worldHash;
+}
+
+std::unique_ptr<Engine> Engine::create(const std::string &name) {
+	if (name == "reference")
+		return std::make_unique<ReferenceEngine>();
+	if (name == "hashed")
+		return std::make_unique<CellsEngine>(false);
+	if (name == "z-order")
+		return std::make_unique<CellsEngine>(true);
+	throw(std::invalid_argument("Unknown engine '" + name + "'. Engines: " + getNames() + "."));
+}
+
+const char *Engine::getNames() {
+	return "reference, hashed, z-order";
+}
+
+int runEngineComparison(const Options &options) {
+	std::string::size_type comma = options.compareEngines.find(',');
+	if (comma == std::string::npos)
+		throw(std::invalid_argument("--compare needs two engines separated by a comma, such as reference,hashed."));
+	std::string engineName1 = options.compareEngines.substr(0, comma), engineName2 = options.compareEngines.substr(comma + 1);
+	Engine::create(engineName1); //Unknown names are reported before anything runs.
+	Engine::create(engineName2);
+
+	Cells::generationType generations = options.generations ? options.generations : defaultGenerations;
+	std::vector<Case> cases = getCases(options);
+
+	std::map<std::string, std::string> finalHashes; //By "case\tgeneration".
+	for (const Case &currentCase : cases) {
+		std::unique_ptr<Engine> engine1 = Engine::create(engineName1), engine2 = Engine::create(engineName2);
+		engine1->load(currentCase.rulesStr, currentCase.aliveCells);
+		engine2->load(currentCase.rulesStr, currentCase.aliveCells);
+
+		for (Cells::generationType generation = 1; generation <= generations; ++generation) {
+			engine1->step();
+			engine2->step();
+
+			if (engine1->getWorldHash().getHash() != engine2->getWorldHash().getHash()) {
+				std::cout << currentCase.name << ": " << engineName1 << " and " << engineName2 << " differ in generation " << generation << ".\n";
+				dumpDifference(std::cout, engineName1, engine1->getAliveCells(), engineName2, engine2->getAliveCells());
+				return 1;
+			}
+		}
+
+		finalHashes[currentCase.name + "\t" + std::to_string(generations)] = toHex(engine1->getWorldHash().getHash());
+	}
+	std::cout << engineName1 << " and " << engineName2 << " agree on " << cases.size() << " cases of " << generations << " generations.\n";
+
+	if (options.goldenFilePath.empty())
+		return 0;
+
+	std::ifstream goldenInput(options.goldenFilePath);
+	if (!goldenInput.is_open()) {
+		std::ofstream goldenOutput(options.goldenFilePath);
+		if (!goldenOutput.is_open())
+			throw(std::logic_error("Error opening golden file '" + options.goldenFilePath + "'."));
+		for (auto &pair : finalHashes) //Case, generation and world hash, separated by tabs.
+			goldenOutput << pair.first << "\t" << pair.second << "\n";
+		std::cout << "Wrote " << finalHashes.size() << " world hashes to " << options.goldenFilePath << ".\n";
+		return 0;
+	}
+
+	int result = 0;
+	std::size_t checked = 0;
+	for (std::string line; std::getline(goldenInput, line);) {
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		std::string::size_type lastTab = line.rfind('\t');
+		if (lastTab == std::string::npos)
+			continue;
+
+		auto it = finalHashes.find(line.substr(0, lastTab));
+		if (it == finalHashes.end()) //Another corpus or amount of generations.
+			continue;
+
+		++checked;
+		if (it->second != line.substr(lastTab + 1)) {
+			std::cout << it->first.substr(0, it->first.find('\t')) << ": world hash " << it->second << " after " << generations << " generations, golden file has " << line.substr(lastTab + 1) << ".\n";
+			result = 1;
+		}
+	}
+	std::cout << checked << " of " << finalHashes.size() << " cases were checked against " << options.goldenFilePath << (result ? ", some differ.\n" : ", all match.\n");
+
+	return result;
+}
@@ -0,0 +1,30 @@
+#ifndef ENGINECOMPARISON_H
+#define ENGINECOMPARISON_H
+
+#include "Position.h"
+#include "CycleDetection.h"
+#include "Options.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+
+class Engine { //A way of simulating an infinite world. Engines are compared generation by generation to make sure they all follow the same rules.
+public:
+	typedef std::vector<Position> cellContainerType;
+
+	virtual ~Engine() = default;
+
+	virtual void load(const std::string &rulesStr, const cellContainerType &aliveCells) = 0; //Called once, before the first step.
+	virtual void step() = 0; //One generation.
+	virtual cellContainerType getAliveCells() const = 0; //In any order.
+
+	virtual WorldHash getWorldHash() const; //Of the alive cells.
+
+	static std::unique_ptr<Engine> create(const std::string &name); //Throws std::invalid_argument for unknown names.
+	static const char *getNames(); //Of every engine create knows, for error messages.
+};
+
+int runEngineComparison(const Options &options); //Run the two engines of options.compareEngines on the map and the corpus, and report the first generation in which they differ. Returns the exit code for main.
+
+#endif
\ No newline at end of file
@@ -4,46 +4,78 @@
 #include <utility>
 #include <cctype>
 #include <string>
+#include <algorithm>
 
 #include "FileProcessing.h"
 #include "Cell.h"
 
-void processMapRuleFiles(char **argv, int argc, Cells *cells) {
-	auto test = argv[1];
-	if (argc != 3)
-		throw(std::invalid_argument("2 arguments must be provided to the program."));
+void processMapRuleFiles(const Options &options, Cells *cells) {
+	if (options.resume) {
+		resumeAutosave(options, cells);
+		return;
+	}
 
 	//Process the rules file first.
-	std::ifstream rulesFileStream(argv[1], std::ios::binary | std::ios::in);
+	cells->setRules(readFile(options.rulesFilePath));
 
-	if (!rulesFileStream.is_open())
-		throw(std::logic_error("Error opening rules file."));
 
-	std::string rules;
-	for (char c; rulesFileStream.get(c);)
-		rules += c;
+	//Process the map file.
+	loadMapFromStr(*cells, readFile(options.mapFilePath), options.wrapAround);
+}
 
-	cells->setRules(rules);
+void loadMapFromStr(Cells &cells, const std::string &mapStr, bool wrapAround, Position offset) {
+	if (wrapAround) {
+		addCellsFromStr(cells, mapStr);
+		Position mapSize = getMapSize(mapStr);
+		cells.setWrapAround(mapSize.x, mapSize.y);
+	}
+	else {
+		Cells::changeContainerType map = getMapFromStr(mapStr);
+		if (offset != Position{ 0, 0 }) {
+			for (auto &cell : map)
+				cell.first = cell.first + offset;
+		}
+		cells.bulkInsert(map); //Neighbors included.
+	}
+}
 
+void resumeAutosave(const Options &options, Cells *cells) {
+	const std::string stateFilePath = Autosave::getStateFilePath(options.mapFilePath);
+	Autosave::State state = Autosave::readState(stateFilePath);
 
-	//Process the map file.
-	std::ifstream mapFileStream(argv[2], std::ios::binary | std::ios::in);
+	cells->setRules(state.rules); //Instead of the rules file, which may have changed since.
+	loadMapFromStr(*cells, readFile(options.mapFilePath), state.worldSize.x > 0, state.offset);
+	if (cells->getStatistics().getPopulation() != state.population)
+		throw(std::logic_error("Autosave '" + options.mapFilePath + "' and its state file '" + stateFilePath + "' are from different saves."));
+	cells->setGeneration(state.generation);
+}
+
+std::string readFile(const std::string &filePath) {
+	std::ifstream fileStream(filePath, std::ios::binary | std::ios::in);
 
-	if (!mapFileStream.is_open())
-		throw(std::logic_error("Error opening map file."));
+	if (!fileStream.is_open())
+		throw(std::logic_error("Error opening file '" + filePath + "'."));
 
-	std::string mapStr;
-	for (char c; mapFileStream.get(c);)
-		mapStr += c;
+	fileStream.seekg(0, std::ios::end); //Read in one go, as maps can be many megabytes.
+	std::string str(static_cast<std::size_t>(fileStream.tellg()), '\0');
+	fileStream.seekg(0, std::ios::beg);
+	fileStream.read(&str[0], str.size());
 
-	addCellsFromStr(*cells, mapStr);
-	cells->addNeighborsToAllCells();
+	return str;
 }
 
 void addCellsFromStr(Cells &cells, std::string str) {
+	for (auto &cell : getMapFromStr(str))
+		cells.insert(std::make_pair(cell.first, Cell(cell.first, cell.second)));
+}
+
+Cells::changeContainerType getMapFromStr(const std::string &str) {
 	if (!str.size())
 		throw(std::logic_error("Map Syntax Error: The map must have at least one cell."));
 
+	Cells::changeContainerType map;
+	map.reserve(std::count(str.begin(), str.end(), '*') + std::count(str.begin(), str.end(), '#'));
+
 	Position currPos{ 0,0 };
 	for (char c : str) {
 		switch (c) {
@@ -53,12 +85,12 @@ void addCellsFromStr(Cells &cells, std::string str) {
 			break;
 
 		case '*':
-			cells.insert(std::make_pair(currPos, Cell(currPos, true)));
+			map.emplace_back(currPos, true);
 			++currPos.x;
 			break;
 
 		case '#':
-			cells.insert(std::make_pair(currPos, Cell(currPos, false)));
+			map.emplace_back(currPos, false);
 			++currPos.x;
 			break;
 
@@ -72,4 +104,64 @@ void addCellsFromStr(Cells &cells, std::string str) {
 			throw(std::logic_error(std::string("Map Syntax Error: character '") + c + "' is not allowed"));
 		}
 	}
+
+	return map;
+}
+
+Cells::changeContainerType getPatternFromStr(const std::string &str) {
+	Cells::changeContainerType pattern;
+
+	Position currPos{ 0,0 };
+	for (char c : str) {
+		switch (c) {
+		case '\n':
+			++currPos.y;
+			currPos.x = 0;
+			break;
+
+		case '*':
+			pattern.emplace_back(currPos, true);
+			++currPos.x;
+			break;
+
+		case '#':
+		case ' ':
+			pattern.emplace_back(currPos, false);
+			++currPos.x;
+			break;
+
+		case '\r':
+			break;
+
+		default:
+			throw(std::logic_error(std::string("Pattern Syntax Error: character '") + c + "' is not allowed"));
+		}
+	}
+
+	return pattern;
+}
+
+Position getMapSize(const std::string &str) {
+	Position size{ 0, 0 };
+
+	Position currPos{ 0,0 };
+	for (char c : str) {
+		switch (c) {
+		case '\n':
+			++currPos.y;
+			currPos.x = 0;
+			break;
+
+		case '\r':
+			break;
+
+		default:
+			++currPos.x;
+			size.x = std::max(size.x, currPos.x);
+			size.y = currPos.y + 1;
+			break;
+		}
+	}
+
+	return size;
 }
\ No newline at end of file
@@ -2,10 +2,17 @@
 #define FILEPROCESSING_H
 
 #include "Cell.h"
+#include "Options.h"
 
 #include <string>
 
-void processMapRuleFiles(char **argv, int argc, Cells *cells); //Arg1: pointer to an array of pointers to c-strings. Arg2: amount of elements in the array.
+void processMapRuleFiles(const Options &options, Cells *cells);
+void loadMapFromStr(Cells &cells, const std::string &mapStr, bool wrapAround, Position offset = Position{ 0, 0 }); //Fill an empty world with a map, its top left corner at offset. If wrapAround, the world becomes the size of the map and its edges wrap around, and offset is not used.
+void resumeAutosave(const Options &options, Cells *cells); //Load the map file as written by Autosave, with the rules, generation and position of the cells from its state file.
+std::string readFile(const std::string &filePath);
 void addCellsFromStr(Cells &cells, std::string str);
+Cells::changeContainerType getMapFromStr(const std::string &str); //The cells of a map, alive (true) or dead (false), row by row. Spaces are left out.
+Position getMapSize(const std::string &str); //Width and height of the map in cells.
+Cells::changeContainerType getPatternFromStr(const std::string &str); //A map as a list of edits relative to its top left corner. Empty and dead cells clear the cells below them.
 
 #endif
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "FrameExport.h"
+
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <stdexcept>
+#include <iomanip>
+#include <sstream>
+
+FrameExporter::imageWriterType FrameExporter::imageWriter;
+
+FrameExporter::FrameExporter(const std::string &d, Position tl, Position s, int sc, generationType e, bool r, unsigned threadCount)
+	: directory{ d }, topLeft{ tl }, size{ s }, scale{ sc }, every{ e }, raw{ r } {
+	if (size.x <= 0 || size.y <= 0 || scale <= 0 || !every)
+		throw(std::invalid_argument("The exported region, the scale and the amount of generations between frames must be positive."));
+	if (!raw && !imageWriter)
+		throw(std::invalid_argument("This build cannot write PNG images. Export raw frames with --export-raw instead."));
+
+	cells.assign(static_cast<std::size_t>(size.x) * size.y, 0);
+
+	std::filesystem::create_directories(directory);
+	if (raw) {
+		std::string rawFilePath = (std::filesystem::path(directory) / "frames.rgba").string();
+		rawFile = std::fopen(rawFilePath.c_str(), "wb");
+		if (!rawFile)
+			throw(std::logic_error("Error opening '" + rawFilePath + "'."));
+	}
+
+	if (!threadCount)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned i = 0; i < threadCount; ++i)
+		threads.emplace_back(&FrameExporter::run, this);
+}
+
+FrameExporter::~FrameExporter() {
+	finish();
+}
+
+void FrameExporter::finish() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	framesAvailable.notify_all();
+	for (std::thread &thread : threads) {
+		if (thread.joinable())
+			thread.join();
+	}
+
+	if (rawFile) {
+		std::fclose(rawFile);
+		rawFile = nullptr;
+	}
+}
+
+void FrameExporter::clear() {
+	std::fill(cells.begin(), cells.end(), 0);
+}
+
+void FrameExporter::exportIfDue(generationType generation) {
+	if (generation % every)
+		return;
+
+	Frame frame{ cells, generation, framesQueued++ };
+
+	std::unique_lock<std::mutex> lock(mutex);
+	spaceAvailable.wait(lock, [this] {
+		return frames.size() < framesPerThread * threads.size();
+	});
+	frames.push_back(std::move(frame));
+	lock.unlock();
+	framesAvailable.notify_one();
+}
+
+void FrameExporter::run() {
+	std::vector<std::uint8_t> pixels; //Reused for every frame this thread writes.
+	for (;;) {
+		std::unique_lock<std::mutex> lock(mutex);
+		framesAvailable.wait(lock, [this] {
+			return stopping || !frames.empty();
+		});
+		if (frames.empty()) //Stopping, and every frame has been taken.
+			return;
+		Frame frame = std::move(frames.front());
+		frames.pop_front();
+		lock.unlock();
+		spaceAvailable.notify_one();
+
+		try {
+			write(frame, pixels);
+		}
+		catch (std::exception &e) { //The simulation goes on without this frame.
+			std::cerr << e.what() << "\n";
+		}
+	}
+}
+
+void FrameExporter::write(const Frame &frame, std::vector<std::uint8_t> &pixels) {
+	Position imageSize = getImageSize();
+	std::size_t rowBytes = static_cast<std::size_t>(imageSize.x) * 4;
+	pixels.resize(rowBytes * imageSize.y);
+
+	const std::uint8_t aliveColor[4] = { 0, 255, 0, 255 }, deadColor[4] = { 0, 0, 0, 255 }; //The colors of the window.
+	for (Position::coordType y = 0; y < size.y; ++y) {
+		std::uint8_t *row = pixels.data() + static_cast<std::size_t>(y) * scale * rowBytes;
+		std::uint8_t *pixel = row;
+		for (Position::coordType x = 0; x < size.x; ++x) {
+			const std::uint8_t *color = frame.cells[static_cast<std::size_t>(y) * size.x + x] ? aliveColor : deadColor;
+			for (int i = 0; i < scale; ++i, pixel += 4)
+				std::copy(color, color + 4, pixel);
+		}
+		for (int i = 1; i < scale; ++i) //Every row of pixels of a row of cells is the same.
+			std::copy(row, row + rowBytes, row + i * rowBytes);
+	}
+
+	if (raw) { //In order, so wait for the frames before this one.
+		std::unique_lock<std::mutex> lock(rawMutex);
+		rawTurn.wait(lock, [this, &frame] {
+			return nextRawIndex == frame.index;
+		});
+		bool written = std::fwrite(pixels.data(), 1, pixels.size(), rawFile) == pixels.size();
+		++nextRawIndex;
+		framesWritten += written;
+		lock.unlock();
+		rawTurn.notify_all();
+
+		if (!written)
+			throw(std::logic_error("Error writing frame of generation " + std::to_string(frame.generation) + " to frames.rgba."));
+		return;
+	}
+
+	std::ostringstream fileName;
+	fileName << "generation_" << std::setw(10) << std::setfill('0') << frame.generation << ".png";
+	std::string filePath = (std::filesystem::path(directory) / fileName.str()).string();
+
+	if (!imageWriter(filePath, pixels.data(), imageSize))
+		throw(std::logic_error("Error writing '" + filePath + "'."));
+	++framesWritten;
+}
@@ -0,0 +1,93 @@
+#ifndef FRAMEEXPORT_H
+#define FRAMEEXPORT_H
+
+#include "Position.h"
+#include "MemoryAccounting.h"
+#include "ChangeListener.h"
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <atomic>
+#include <functional>
+
+class FrameExporter : public ChangeListener { //Writes every Nth generation of a region of the world as an image, without a window. The simulation thread only keeps one byte per cell of the region up to date and copies it once per frame; a pool of threads turns the copies into pixels and writes them.
+public:
+	typedef std::vector<std::uint8_t, TaggedAllocator<std::uint8_t, MemoryAccounting::rendering>> frameContainerType; //1 for each alive cell of the region, row by row.
+	typedef unsigned long long generationType;
+	typedef std::function<bool(const std::string &filePath, const std::uint8_t *pixels, Position size)> imageWriterType; //Writes RGBA pixels, row by row, to a PNG image. Returns false if it failed.
+
+	static constexpr std::size_t framesPerThread = 4; //Frames waiting to be written, at most. The simulation waits when the threads fall this far behind, so memory use stays bounded.
+
+	static void setImageWriter(imageWriterType writer) { //Encoding images is left to a graphics library, which the simulation does not depend on. Without a writer, only raw frames can be exported.
+		imageWriter = std::move(writer);
+	}
+
+	//Frames are written to directory as PNG images named after their generation, or appended to directory/frames.rgba if raw is set, for a video encoder such as ffmpeg. scale is the width and height of a cell in pixels.
+	FrameExporter(const std::string &directory, Position topLeft, Position size, int scale, generationType every, bool raw, unsigned threadCount);
+	~FrameExporter();
+
+	FrameExporter(const FrameExporter &) = delete;
+	FrameExporter &operator=(const FrameExporter &) = delete;
+
+	void update(Position pos, bool alive) override {
+		pos = pos - topLeft;
+		if (pos.x >= 0 && pos.y >= 0 && pos.x < size.x && pos.y < size.y)
+			cells[static_cast<std::size_t>(pos.y) * size.x + pos.x] = alive;
+	}
+
+	void clear() override;
+
+	void exportIfDue(generationType generation); //Called after each generation.
+	void finish(); //Wait until every frame is written. No frames can be added afterwards.
+
+	Position getImageSize() const noexcept { //In pixels.
+		return Position{ size.x * scale, size.y * scale };
+	}
+
+	std::size_t getFramesWritten() const noexcept {
+		return framesWritten.load();
+	}
+
+private:
+	class Frame {
+	public:
+		frameContainerType cells;
+		generationType generation;
+		std::size_t index; //Frames are appended to a raw stream in this order.
+	};
+
+	static imageWriterType imageWriter;
+
+	void run(); //A thread of the pool.
+	void write(const Frame &frame, std::vector<std::uint8_t> &pixels);
+
+	std::string directory;
+	Position topLeft, size;
+	int scale;
+	generationType every;
+	bool raw;
+	frameContainerType cells; //Owned by the simulation thread.
+	std::size_t framesQueued{ 0 };
+
+	std::deque<Frame> frames; //Guarded by mutex.
+	bool stopping{ false };
+	std::mutex mutex;
+	std::condition_variable framesAvailable, spaceAvailable;
+
+	std::FILE *rawFile{ nullptr };
+	std::size_t nextRawIndex{ 0 }; //The frame to append to the raw stream next. Guarded by rawMutex, which is only held by the pool, so writing never blocks the simulation.
+	std::mutex rawMutex;
+	std::condition_variable rawTurn;
+
+	std::atomic<std::size_t> framesWritten{ 0 };
+	std::vector<std::thread> threads; //Last, so everything they use exists before they start.
+};
+
+#endif
\ No newline at end of file
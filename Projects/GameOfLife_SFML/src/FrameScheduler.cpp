@@ -0,0 +1,37 @@
+#include "FrameScheduler.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+bool FrameScheduler::waitEvent(sf::Event &event, clockType::time_point deadline) {
+	if (frameRequested)
+		deadline = std::min(deadline, nextFrameTime);
+
+	for (;;) {
+		if (window->pollEvent(event)) {
+			frameRequested = true;
+			return true;
+		}
+
+		const auto now = clockType::now();
+		if (now >= deadline)
+			return false;
+
+		if (deadline == clockType::time_point::max()) { //Nothing happens until there is input.
+			if (!window->waitEvent(event))
+				return false;
+
+			frameRequested = true;
+			return true;
+		}
+
+		const auto remaining = deadline - now;
+		if (remaining > spinTime) //sf::sleep raises the timer resolution on Windows, unlike std::this_thread::sleep_for.
+			sf::sleep(sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(std::min<clockType::duration>(remaining - spinTime, maxSleepTime)).count()));
+		else
+			std::this_thread::yield();
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <SFML/Graphics.hpp>
+
+#include <chrono>
+
+class FrameScheduler { //Decides when the window is redrawn, and sleeps or waits for events until the next frame or tick is due instead of spinning. A paused world with nothing left to save blocks on the event queue and uses no CPU.
+public:
+	typedef std::chrono::steady_clock clockType;
+
+	static constexpr std::chrono::microseconds spinTime{ 500 }; //The last part of a wait is spent yielding, since sleeping may overshoot the deadline.
+	static constexpr std::chrono::milliseconds maxSleepTime{ 10 }; //Events are checked at least this often while waiting for a deadline.
+
+	FrameScheduler(sf::RenderWindow &w, std::chrono::nanoseconds mft) : window{ &w }, minFrameTime{ mft } {}
+
+	void requestFrame() { //Something on screen changed.
+		frameRequested = true;
+	}
+
+	bool frameDue() const {
+		return frameRequested && clockType::now() >= nextFrameTime;
+	}
+
+	void frameRendered() {
+		frameRequested = false;
+		nextFrameTime = clockType::now() + minFrameTime;
+	}
+
+	bool waitEvent(sf::Event &event, clockType::time_point deadline); //Returns the next event, or false once all events are handled and deadline, or the next requested frame, is due. Every event requests a frame.
+
+private:
+	sf::RenderWindow *window;
+	std::chrono::nanoseconds minFrameTime;
+	clockType::time_point nextFrameTime{ clockType::now() };
+	bool frameRequested{ true };
+};
+
+#endif
\ No newline at end of file
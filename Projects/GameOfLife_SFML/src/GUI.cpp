@@ -6,25 +6,288 @@
 
 #include <vector>
 #include <chrono>
+#include <string_view>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <iterator>
+#include <string>
+#include <limits>
+#include <exception>
 
 const sf::Vector2f textureSize(32, 32);
 
-void Button::render(Window &window, sf::Texture texture) {
-	std::vector<sf::Vertex> vertices;
+namespace {
+	constexpr std::string_view glyphCharacters = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ:.,-+=/()%_^";
+
+	const char *getGlyphPixels(char c) { //3x5 glyphs, row by row. '#' is a lit pixel.
+		switch (std::toupper(static_cast<unsigned char>(c))) {
+		case '0': return "####.##.##.####";
+		case '1': return ".#.##..#..#.###";
+		case '2': return "###..#####..###";
+		case '3': return "###..####..####";
+		case '4': return "#.##.####..#..#";
+		case '5': return "####..###..####";
+		case '6': return "####..####.####";
+		case '7': return "###..#..#..#..#";
+		case '8': return "####.#####.####";
+		case '9': return "####.####..####";
+		case 'A': return ".#.#.####.##.##";
+		case 'B': return "##.#.###.#.###.";
+		case 'C': return ".###..#..#...##";
+		case 'D': return "##.#.##.##.###.";
+		case 'E': return "####..##.#..###";
+		case 'F': return "####..##.#..#..";
+		case 'G': return ".###..#.##.#.##";
+		case 'H': return "#.##.####.##.##";
+		case 'I': return "###.#..#..#.###";
+		case 'J': return "..#..#..##.#.#.";
+		case 'K': return "#.##.###.#.##.#";
+		case 'L': return "#..#..#..#..###";
+		case 'M': return "#.#######.##.##";
+		case 'N': return "##.#.##.##.##.#";
+		case 'O': return ".#.#.##.##.#.#.";
+		case 'P': return "##.#.###.#..#..";
+		case 'Q': return ".#.#.##.###..##";
+		case 'R': return "##.#.###.#.##.#";
+		case 'S': return ".###...#...###.";
+		case 'T': return "###.#..#..#..#.";
+		case 'U': return "#.##.##.##.####";
+		case 'V': return "#.##.##.##.#.#.";
+		case 'W': return "#.##.#######.##";
+		case 'X': return "#.##.#.#.#.##.#";
+		case 'Y': return "#.##.#.#..#..#.";
+		case 'Z': return "###..#.#.#..###";
+		case ':': return "....#.....#....";
+		case '.': return ".............#.";
+		case ',': return "..........#.#..";
+		case '-': return "......###......";
+		case '+': return "....#.###.#....";
+		case '=': return "...###...###...";
+		case '/': return "..#..#.#.#..#..";
+		case '(': return ".#.#..#..#...#.";
+		case ')': return ".#...#..#..#.#.";
+		case '%': return "#.#..#.#.#..#.#";
+		case '_': return "............###";
+		case '^': return ".#.#.#.........";
+		default: return "...............";
+		}
+	}
+}
 
-	float textureBeginX = buttonTextureFactor * textureSize.x;
 
-	vertices.emplace_back(sf::Vector2f(getPosition().x, getPosition().y), sf::Vector2f(textureBeginX, 0));
-	vertices.emplace_back(sf::Vector2f(getPosition().x + getSize().x, getPosition().y), sf::Vector2f(textureBeginX + textureSize.x, 0));
-	vertices.emplace_back(sf::Vector2f(getPosition().x + getSize().x, getPosition().y + getSize().y), sf::Vector2f(textureBeginX + textureSize.x, textureSize.y));
-	vertices.emplace_back(sf::Vector2f(getPosition().x, getPosition().y + getSize().y), sf::Vector2f(textureBeginX, textureSize.y));
+GUIBatch::GUIBatch(const sf::Image &buttonImage) {
+	//The atlas is the button image with a row of glyphs below it, followed by a white area.
+	const sf::Vector2u buttonImageSize = buttonImage.getSize();
+	const unsigned glyphSpacing = static_cast<unsigned>(glyphWidth) + 1;
+	const unsigned fontWidth = static_cast<unsigned>(glyphCharacters.size()) * glyphSpacing + 2;
+	const unsigned fontTop = buttonImageSize.y + 1;
+
+	sf::Image image;
+	image.create(std::max(buttonImageSize.x, fontWidth), fontTop + static_cast<unsigned>(glyphHeight), sf::Color::Transparent);
+	image.copy(buttonImage, 0, 0);
+
+	glyphTextureCoords.fill(sf::Vector2f(-1, -1));
+	for (std::size_t i = 0; i < glyphCharacters.size(); ++i) {
+		const unsigned left = static_cast<unsigned>(i) * glyphSpacing;
+		const char *pixels = getGlyphPixels(glyphCharacters[i]);
+		for (unsigned row = 0; row < glyphHeight; ++row) {
+			for (unsigned column = 0; column < glyphWidth; ++column) {
+				if (pixels[row * 3 + column] == '#')
+					image.setPixel(left + column, fontTop + row, sf::Color::White);
+			}
+		}
+
+		const sf::Vector2f coords(static_cast<float>(left), static_cast<float>(fontTop));
+		glyphTextureCoords[static_cast<unsigned char>(glyphCharacters[i])] = coords;
+		glyphTextureCoords[static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(glyphCharacters[i])))] = coords;
+	}
+
+	const unsigned whiteLeft = fontWidth - 2;
+	for (unsigned y = 0; y < 2; ++y) {
+		for (unsigned x = 0; x < 2; ++x)
+			image.setPixel(whiteLeft + x, fontTop + y, sf::Color::White);
+	}
+	whitePixel = sf::Vector2f(static_cast<float>(whiteLeft + 1), static_cast<float>(fontTop + 1)); //The middle of the 2x2 white area, so every texel sampled there is white.
+
+	atlas.loadFromImage(image);
+}
+
+void GUIBatch::addQuad(sf::FloatRect rect, sf::FloatRect textureRect, sf::Color color) {
+	vertices.emplace_back(sf::Vector2f(rect.left, rect.top), color, sf::Vector2f(textureRect.left, textureRect.top));
+	vertices.emplace_back(sf::Vector2f(rect.left + rect.width, rect.top), color, sf::Vector2f(textureRect.left + textureRect.width, textureRect.top));
+	vertices.emplace_back(sf::Vector2f(rect.left + rect.width, rect.top + rect.height), color, sf::Vector2f(textureRect.left + textureRect.width, textureRect.top + textureRect.height));
+	vertices.emplace_back(sf::Vector2f(rect.left, rect.top + rect.height), color, sf::Vector2f(textureRect.left, textureRect.top + textureRect.height));
+}
+
+void GUIBatch::addRect(sf::FloatRect rect, sf::Color color) {
+	addQuad(rect, sf::FloatRect(whitePixel.x, whitePixel.y, 0, 0), color);
+}
+
+float GUIBatch::addText(std::string_view str, sf::Vector2f topLeft, float pixelSize, sf::Color color) {
+	for (char c : str) {
+		const sf::Vector2f coords = glyphTextureCoords[static_cast<unsigned char>(c)];
+		if (coords.x >= 0) //Characters without a glyph, such as spaces, are left empty.
+			addQuad(sf::FloatRect(topLeft.x, topLeft.y, glyphWidth * pixelSize, glyphHeight * pixelSize), sf::FloatRect(coords.x, coords.y, glyphWidth, glyphHeight), color);
+		topLeft.x += (glyphWidth + 1) * pixelSize;
+	}
+
+	return topLeft.x;
+}
+
+void GUIBatch::draw(Window &window) const {
+	if (vertices.empty())
+		return;
 
 	window.getSFMLWindow().setView(window.getSFMLWindow().getDefaultView());
 
-	sf::RenderStates rs(&texture);
+	sf::RenderStates rs(&atlas);
 	window.getSFMLWindow().draw(vertices.data(), vertices.size(), sf::Quads, rs);
 }
 
+void appendNumber(std::string &str, long long number) {
+	char buffer[24];
+	str.append(buffer, std::to_chars(std::begin(buffer), std::end(buffer), number).ptr);
+}
+
+bool JumpControls::onKeyPressed(sf::Keyboard::Key key) {
+	int digit = -1;
+	if (key >= sf::Keyboard::Num0 && key <= sf::Keyboard::Num9)
+		digit = key - sf::Keyboard::Num0;
+	else if (key >= sf::Keyboard::Numpad0 && key <= sf::Keyboard::Numpad9)
+		digit = key - sf::Keyboard::Numpad0;
+
+	if (cells->getJumping()) { //Only Escape, which cancels the jump, works until it is finished.
+		if (key != sf::Keyboard::Escape)
+			return false;
+		cells->cancelJump();
+		return true;
+	}
+
+	error.clear();
+	try {
+		if (digit >= 0) {
+			if (typedGeneration <= (std::numeric_limits<Cells::generationType>::max() - digit) / 10)
+				typedGeneration = typedGeneration * 10 + digit;
+			typing = true;
+			return true;
+		}
+
+		switch (key) {
+		case sf::Keyboard::G:
+			if (typing)
+				cells->beginJump(typedGeneration);
+			typing = false;
+			typedGeneration = 0;
+			return true;
+
+		case sf::Keyboard::J:
+			cells->beginJump(cells->getStepTarget(stepExponent));
+			return true;
+
+		case sf::Keyboard::LBracket:
+			if (stepExponent > 0)
+				--stepExponent;
+			return true;
+
+		case sf::Keyboard::RBracket:
+			if (stepExponent < Cells::maxStepExponent)
+				++stepExponent;
+			return true;
+
+		case sf::Keyboard::Escape: { //Forget the typed generation.
+			const bool wasTyping = typing;
+			typing = false;
+			typedGeneration = 0;
+			return wasTyping;
+		}
+		}
+	}
+	catch (std::exception &e) {
+		error = e.what();
+		return true;
+	}
+
+	return false;
+}
+
+bool JumpControls::update() {
+	text.clear();
+
+	const Cells::JumpReport &lastJump = cells->getLastJump();
+	if (cells->getJumping()) {
+		text += "JUMPING TO GENERATION ";
+		appendNumber(text, static_cast<long long>(cells->getJumpTarget()));
+		text += ", AT ";
+		appendNumber(text, static_cast<long long>(cells->getGeneration()));
+		text += "\nPRESS ESCAPE TO CANCEL\n";
+	}
+	else if (!error.empty() || !lastJump.error.empty()) {
+		text += error.empty() ? lastJump.error : error;
+		text += '\n';
+	}
+	else if (lastJump.to != lastJump.from) {
+		text += "JUMPED ";
+		appendNumber(text, static_cast<long long>(lastJump.to - lastJump.from));
+		text += " GENERATIONS IN ";
+		if (lastJump.timeTaken < std::chrono::milliseconds(10)) {
+			appendNumber(text, std::chrono::duration_cast<std::chrono::microseconds>(lastJump.timeTaken).count());
+			text += " US";
+		}
+		else {
+			appendNumber(text, std::chrono::duration_cast<std::chrono::milliseconds>(lastJump.timeTaken).count());
+			text += " MS";
+		}
+		text += lastJump.skippedCycles ? ", SKIPPING CYCLES" : "";
+		text += lastJump.cancelled ? ", CANCELLED\n" : "\n";
+	}
+
+	if (typing) {
+		text += "GO TO GENERATION ";
+		appendNumber(text, static_cast<long long>(typedGeneration));
+		text += "_\n";
+	}
+	else {
+		text += "STEP 2^";
+		appendNumber(text, stepExponent);
+		text += " = ";
+		appendNumber(text, static_cast<long long>(Cells::generationType(1) << stepExponent));
+		text += '\n';
+	}
+
+	if (text == builtText)
+		return false;
+
+	text.swap(builtText);
+	return true;
+}
+
+void JumpControls::build(GUIBatch &batch) const {
+	const float lineHeight = (GUIBatch::glyphHeight + 2) * pixelSize;
+
+	std::size_t lineCount = std::count(builtText.begin(), builtText.end(), '\n');
+	sf::Vector2f cursor(getPosition().x, getPosition().y - lineCount * lineHeight);
+	for (std::size_t lineBegin = 0, lineEnd; lineBegin < builtText.size(); lineBegin = lineEnd + 1) {
+		lineEnd = builtText.find('\n', lineBegin);
+		batch.addText(std::string_view(builtText).substr(lineBegin, lineEnd - lineBegin), cursor, pixelSize);
+		cursor.y += lineHeight;
+	}
+}
+
+bool Button::update() {
+	if (disabled == cells->getJumping())
+		return false;
+
+	disabled = cells->getJumping();
+	return true;
+}
+
+void Button::build(GUIBatch &batch) const {
+	float textureBeginX = buttonTextureFactor * textureSize.x;
+
+	batch.addQuad(sf::FloatRect(getPosition(), getSize()), sf::FloatRect(textureBeginX, 0, textureSize.x, textureSize.y), disabled ? sf::Color(96, 96, 96) : sf::Color::White);
+}
+
 void FastForwardButton::onClick() {
 	if (!cells->getPause()) {
 		auto tickAimTime = cells->getTickAimTime();
@@ -5,11 +5,15 @@
 #include <memory>
 #include <utility>
 #include <chrono>
+#include <array>
+#include <string>
+#include <string_view>
 
 #include <SFML/Graphics.hpp>
 
 #include "Cell.h"
 #include "Window.h"
+#include "MemoryAccounting.h"
 
 extern const sf::Vector2f textureSize;
 
@@ -25,17 +29,44 @@ enum GUITextureCoordFactors {
 	fastForwardButton
 };
 
+class GUIBatch { //Every widget is drawn as quads into one vertex array, using one texture atlas that holds the button textures and a pixel font. So all widgets take a single draw call.
+public:
+	GUIBatch(const sf::Image &buttonImage);
+
+	void clear() {
+		vertices.clear();
+	}
+
+	void addQuad(sf::FloatRect rect, sf::FloatRect textureRect, sf::Color color = sf::Color::White);
+	void addRect(sf::FloatRect rect, sf::Color color); //Untextured.
+	float addText(std::string_view str, sf::Vector2f topLeft, float pixelSize, sf::Color color = sf::Color::White); //Returns where the text ends on the x axis.
+
+	void draw(Window &window) const;
+
+	static constexpr float glyphWidth = 3, glyphHeight = 5; //In font pixels.
+
+private:
+	sf::Texture atlas;
+	std::vector<sf::Vertex, TaggedAllocator<sf::Vertex, MemoryAccounting::rendering>> vertices; //Reused between rebuilds.
+	std::array<sf::Vector2f, 256> glyphTextureCoords; //Top left of each character in the atlas, or x < 0 if it has no glyph.
+	sf::Vector2f whitePixel; //Texture coordinates of a white area, for untextured quads.
+};
+
 class GUI {
 public:
 	GUI(sf::FloatRect rect) : position{ rect.left, rect.top }, size{ rect.width, rect.height } {}
+	virtual ~GUI() = default;
 
-	virtual void render(Window &window, sf::Texture texture) = 0;
+	virtual void build(GUIBatch &batch) const = 0; //Add the quads of the widget.
+	virtual bool update() { //Called every frame. Returns true if the look of the widget changed, so the batch needs to be rebuilt.
+		return false;
+	}
 
-	sf::Vector2f getPosition() {
+	sf::Vector2f getPosition() const {
 		return position;
 	}
 
-	sf::Vector2f getSize() {
+	sf::Vector2f getSize() const {
 		return size;
 	}
 
@@ -46,67 +77,81 @@ private:
 	sf::Vector2f size; //Width and length.
 };
 
-class Button : public GUI {
+class Button : public GUI { //Greyed out and ignored while a jump is in progress.
 public:
-	Button(GUITextureCoordFactors bTF, sf::FloatRect rect) : GUI(rect), buttonTextureFactor{ bTF }{}
+	Button(GUITextureCoordFactors bTF, sf::FloatRect rect, Cells &c) : GUI(rect), cells{ &c }, buttonTextureFactor{ bTF }{}
 
-	void render(Window &window, sf::Texture texture) override;
+	bool update() override;
+	void build(GUIBatch &batch) const override;
 	virtual void onClick() = 0;
 
+protected:
+	Cells *cells;
+
 private:
 	GUITextureCoordFactors buttonTextureFactor;
+	bool disabled{ false };
 };
 
 class FastForwardButton : public Button {
 public:
-	FastForwardButton(sf::FloatRect rect, Cells &c) : Button(GUITextureCoordFactors::fastForwardButton, rect), cells{ &c }{}
+	FastForwardButton(sf::FloatRect rect, Cells &c) : Button(GUITextureCoordFactors::fastForwardButton, rect, c) {}
 
 	void onClick() override;
-
-private:
-	Cells *cells;
 };
 
 class StepForwardButton : public Button {
 public:
-	StepForwardButton(sf::FloatRect rect, Cells &c) : Button(GUITextureCoordFactors::stepForwardButton, rect), cells{ &c }{}
+	StepForwardButton(sf::FloatRect rect, Cells &c) : Button(GUITextureCoordFactors::stepForwardButton, rect, c) {}
 
 	void onClick() override;
-
-private:
-	Cells *cells;
 };
 
 class PauseButton : public Button {
 public:
-	PauseButton(sf::FloatRect rect, Cells &c) : Button(GUITextureCoordFactors::pauseButton, rect), cells{ &c }{}
+	PauseButton(sf::FloatRect rect, Cells &c) : Button(GUITextureCoordFactors::pauseButton, rect, c) {}
 
 	void onClick() override;
-
-private:
-	Cells *cells;
 };
 
 class StepBackwardButton : public Button {
 public:
-	StepBackwardButton(sf::FloatRect rect, Cells &c) : Button(GUITextureCoordFactors::stepBackwardButton, rect), cells{ &c }{}
+	StepBackwardButton(sf::FloatRect rect, Cells &c) : Button(GUITextureCoordFactors::stepBackwardButton, rect, c) {}
 
 	void onClick() override;
-
-private:
-	Cells *cells;
 };
 
 class RewindButton : public Button {
 public:
-	RewindButton(sf::FloatRect rect, Cells &c) : Button(GUITextureCoordFactors::rewindButton, rect), cells{ &c }{}
+	RewindButton(sf::FloatRect rect, Cells &c) : Button(GUITextureCoordFactors::rewindButton, rect, c) {}
 
 	void onClick() override;
+};
+
+class JumpControls : public GUI { //Keyboard controls that simulate many generations at once: type a generation and press G to go to it, or press J to step 2^k generations ahead, where [ and ] change k. Escape cancels a jump in progress. Shows its progress, or how long the last jump took, above bottomLeft.
+public:
+	JumpControls(sf::Vector2f bottomLeft, Cells &c) : GUI(sf::FloatRect(bottomLeft.x, bottomLeft.y, 0, 0)), cells{ &c } {}
+
+	bool onKeyPressed(sf::Keyboard::Key key); //Returns true if the key was used.
+
+	bool update() override;
+	void build(GUIBatch &batch) const override;
+	void onClick() override {}
 
 private:
+	static constexpr float pixelSize = 3; //Size of a single pixel of the font, in screen pixels.
+
 	Cells *cells;
+	Cells::generationType typedGeneration{ 0 };
+	bool typing{ false };
+	unsigned stepExponent{ 10 };
+	std::string error; //Of the last command, shown until the next key is pressed.
+	std::string text; //Lines ending with '\n'. Reused between frames.
+	std::string builtText; //The text the batch was last built with.
 };
 
+void appendNumber(std::string &str, long long number); //Without allocating, unlike std::to_string.
+
 class GUIs {
 	typedef std::vector<std::shared_ptr<GUI>> GUIsContainerType;
 
@@ -150,20 +195,27 @@ public:
 	typedef std::size_t size_type;
 	typedef iterator<GUIsContainerType::const_iterator> const_iterator;
 
-	GUIs(sf::Texture t) : texture{ t } {}
+	GUIs(const sf::Image &buttonImage) : batch{ buttonImage } {}
 
-	void render(Window &window) {
-		for (std::shared_ptr<GUI> gui : guis) {
-			gui->render(window, texture);
+	void render(Window &window) { //Rebuild the vertices only if a widget changed, then draw all widgets at once.
+		for (const std::shared_ptr<GUI> &gui : guis) {
+			if (gui->update())
+				dirty = true;
+		}
+
+		if (dirty) {
+			batch.clear();
+			for (const std::shared_ptr<GUI> &gui : guis)
+				gui->build(batch);
+			dirty = false;
 		}
-	}
 
-	sf::Texture &getTexture() {
-		return texture;
+		batch.draw(window);
 	}
 
-	template<typename T, typename... Types> GUI &emplace(Types&&... args) {
-		return *guis.emplace_back(std::make_shared<T>(std::forward<Types>(args)...));
+	template<typename T, typename... Types> T &emplace(Types&&... args) {
+		dirty = true;
+		return static_cast<T &>(*guis.emplace_back(std::make_shared<T>(std::forward<Types>(args)...)));
 	}
 
 	auto begin() {
@@ -181,7 +233,8 @@ public:
 
 private:
 	GUIsContainerType guis;
-	sf::Texture texture;
+	GUIBatch batch;
+	bool dirty{ true };
 };
 
 #endif
\ No newline at end of file
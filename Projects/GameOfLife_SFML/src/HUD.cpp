@@ -0,0 +1,176 @@
+#include "HUD.h"
+#include "Cell.h"
+#include "Profiler.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+
+bool HUD::update() {
+	updateSpeed();
+
+	text.clear();
+	if (visible) {
+		const WorldStatistics &statistics = cells->getStatistics();
+
+		text += "GENERATION ";
+		appendNumber(text, static_cast<long long>(cells->getGeneration()));
+		text += "\nPOPULATION ";
+		appendNumber(text, static_cast<long long>(statistics.getPopulation()));
+		text += '\n';
+
+		if (cells->getPause()) {
+			text += "PAUSED\n";
+		}
+		else {
+			text += cells->getRewinding() ? "REWIND " : "SPEED ";
+			appendNumber(text, generationsPerSecond);
+			text += " GEN/S AIM ";
+			const auto aimTime = cells->getRewinding() ? cells->getTickRewindAimTime() : cells->getTickAimTime();
+			if (aimTime.count()) {
+				appendNumber(text, std::chrono::duration_cast<std::chrono::milliseconds>(aimTime).count());
+				text += "MS\n";
+			}
+			else {
+				text += "MAX\n";
+			}
+		}
+
+		text += "BIRTHS ";
+		appendNumber(text, static_cast<long long>(statistics.getBirths()));
+		text += " DEATHS ";
+		appendNumber(text, static_cast<long long>(statistics.getDeaths()));
+		text += '\n';
+
+		Position boundingBoxMin = statistics.getBoundingBoxMin(), boundingBoxMax = statistics.getBoundingBoxMax();
+		text += "BOX (";
+		appendNumber(text, boundingBoxMin.x);
+		text += ',';
+		appendNumber(text, boundingBoxMin.y);
+		text += ") (";
+		appendNumber(text, boundingBoxMax.x);
+		text += ',';
+		appendNumber(text, boundingBoxMax.y);
+		text += ")\n";
+
+		const CycleDetector *cycleDetector = cells->getCycleDetector();
+		if (cycleDetector && cycleDetector->found()) {
+			text += "CYCLE PERIOD ";
+			appendNumber(text, static_cast<long long>(cycleDetector->getCycle().period));
+			text += '\n';
+		}
+
+		if (!editor->getMessage().empty()) {
+			text += editor->getMessage();
+			text += '\n';
+		}
+
+		if (showProfile) {
+			const Profiler &profiler = Profiler::get();
+			for (int phase = 0; phase < Profiler::phaseCount; ++phase) {
+				if (!profiler.getSampleCount(Profiler::Phase(phase)))
+					continue;
+
+				text += Profiler::getPhaseName(Profiler::Phase(phase));
+				text += " P50 ";
+				appendNumber(text, std::chrono::duration_cast<std::chrono::microseconds>(profiler.getPercentile(Profiler::Phase(phase), 50)).count());
+				text += "US P99 ";
+				appendNumber(text, std::chrono::duration_cast<std::chrono::microseconds>(profiler.getPercentile(Profiler::Phase(phase), 99)).count());
+				text += "US\n";
+			}
+		}
+
+		if (showMemory) {
+			updateMemoryReport();
+			text += memoryReport;
+		}
+	}
+
+	if (text == builtText)
+		return false;
+
+	text.swap(builtText);
+	return true;
+}
+
+void HUD::build(GUIBatch &batch) const {
+	if (builtText.empty())
+		return;
+
+	const float lineHeight = (GUIBatch::glyphHeight + 2) * pixelSize, characterWidth = (GUIBatch::glyphWidth + 1) * pixelSize;
+	const float margin = pixelSize * 2;
+
+	std::size_t lineCount = 0, longestLine = 0;
+	for (std::size_t lineBegin = 0, lineEnd; lineBegin < builtText.size(); lineBegin = lineEnd + 1, ++lineCount) {
+		lineEnd = builtText.find('\n', lineBegin);
+		longestLine = std::max(longestLine, lineEnd - lineBegin);
+	}
+
+	//Darken the area behind the text so it stays readable on top of cells.
+	batch.addRect(sf::FloatRect(0, 0, margin + longestLine * characterWidth + pixelSize * 4, margin + lineCount * lineHeight + pixelSize), sf::Color(0, 0, 0, 160));
+
+	sf::Vector2f cursor(margin, margin);
+	for (std::size_t lineBegin = 0, lineEnd; lineBegin < builtText.size(); lineBegin = lineEnd + 1) {
+		lineEnd = builtText.find('\n', lineBegin);
+		batch.addText(std::string_view(builtText).substr(lineBegin, lineEnd - lineBegin), cursor, pixelSize);
+		cursor.y += lineHeight;
+	}
+}
+
+void HUD::updateMemoryReport() {
+	const auto now = std::chrono::steady_clock::now();
+	if (!memoryReport.empty() && now - memoryReportTime < memoryReportInterval)
+		return;
+	memoryReportTime = now;
+
+	memoryReport.clear();
+	for (int tag = 0; tag < MemoryAccounting::tagCount; ++tag) {
+		memoryReport += MemoryAccounting::getTagName(MemoryAccounting::Tag(tag));
+		memoryReport += ": ";
+		appendNumber(memoryReport, static_cast<long long>(MemoryAccounting::getBytes(MemoryAccounting::Tag(tag)) / 1024));
+		memoryReport += " KB IN ";
+		appendNumber(memoryReport, static_cast<long long>(MemoryAccounting::getAllocations(MemoryAccounting::Tag(tag))));
+		memoryReport += " ALLOCATIONS\n";
+	}
+
+	const std::size_t totalBytes = MemoryAccounting::getTotalBytes(), population = cells->getStatistics().getPopulation();
+	memoryReport += "TOTAL: ";
+	appendNumber(memoryReport, static_cast<long long>(totalBytes / 1024));
+	memoryReport += " KB";
+	if (population) {
+		memoryReport += ", ";
+		appendNumber(memoryReport, static_cast<long long>(totalBytes / population));
+		memoryReport += " BYTES PER ALIVE CELL";
+	}
+	memoryReport += '\n';
+
+	if (!cells->getWrapAround()) {
+		const long long loadFactor = std::llround(cells->getLoadFactor() * 100); //In hundredths.
+		memoryReport += "HASH MAP: ";
+		appendNumber(memoryReport, static_cast<long long>(cells->size()));
+		memoryReport += " CELLS IN ";
+		appendNumber(memoryReport, static_cast<long long>(cells->getBucketCount()));
+		memoryReport += " BUCKETS, LOAD FACTOR ";
+		appendNumber(memoryReport, loadFactor / 100);
+		memoryReport += '.';
+		memoryReport += static_cast<char>('0' + loadFactor / 10 % 10);
+		memoryReport += static_cast<char>('0' + loadFactor % 10);
+		memoryReport += '\n';
+	}
+}
+
+void HUD::updateSpeed() { //Generations per second, measured over the last sample interval.
+	const auto now = std::chrono::steady_clock::now();
+	if (now - speedSampleTime < speedSampleInterval)
+		return;
+
+	const long long generations = static_cast<long long>(cells->getGeneration() - speedSampleGeneration); //Negative while rewinding.
+	generationsPerSecond = std::llabs(generations) * 1000 / std::max<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(now - speedSampleTime).count(), 1);
+	speedSampleGeneration = cells->getGeneration();
+	speedSampleTime = now;
+}
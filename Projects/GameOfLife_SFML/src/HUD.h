@@ -0,0 +1,60 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include "Cell.h"
+#include "GUI.h"
+#include "Editor.h"
+#include "MemoryAccounting.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <string>
+#include <chrono>
+
+class HUD : public GUI { //Text in the top left corner of the window showing statistics of the world, drawn with the pixel font of the GUI batch. The text is formatted into reused buffers every frame, and the batch is only rebuilt when it changed.
+public:
+	HUD(const Cells &c, const Editor &e) : GUI(sf::FloatRect(0, 0, 0, 0)), cells{ &c }, editor{ &e } {}
+
+	bool update() override;
+	void build(GUIBatch &batch) const override;
+	void onClick() override {}
+
+	void toggleVisible() {
+		visible = !visible;
+	}
+
+	void toggleMemory() { //Show how much memory each subsystem uses.
+		showMemory = !showMemory;
+	}
+
+	void toggleProfile() { //Show the p50 and p99 durations of each phase of a tick and a frame.
+		showProfile = !showProfile;
+	}
+
+	bool getVisible() const noexcept {
+		return visible;
+	}
+
+private:
+	void updateSpeed();
+	void updateMemoryReport(); //Like writeMemoryReport, appended into memoryReport without allocating.
+
+	static constexpr float pixelSize = 3; //Size of a single pixel of the font, in screen pixels.
+	static constexpr std::chrono::milliseconds speedSampleInterval{ 500 };
+	static constexpr std::chrono::milliseconds memoryReportInterval{ 500 }; //The report changes with every tick, but cannot be read that fast.
+
+	const Cells *cells;
+	const Editor *editor;
+	std::string text; //Lines ending with '\n'. Reused between frames.
+	std::string builtText; //The text the batch was last built with.
+	std::string memoryReport; //Reused between frames. Rebuilt every memoryReportInterval.
+	std::chrono::steady_clock::time_point memoryReportTime;
+	CycleDetector::generationType speedSampleGeneration{ 0 };
+	std::chrono::steady_clock::time_point speedSampleTime{ std::chrono::steady_clock::now() };
+	long long generationsPerSecond{ 0 };
+	bool visible{ true };
+	bool showProfile{ false };
+	bool showMemory{ false };
+};
+
+#endif
\ No newline at end of file
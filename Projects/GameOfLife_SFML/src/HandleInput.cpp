@@ -2,12 +2,17 @@
 #include "Window.h"
 #include "GUI.h"
 #include "Map.h"
+#include "HUD.h"
+#include "Editor.h"
 
 #include <SFML/Graphics.hpp>
 
-void handleKeyPressed(sf::Event::KeyEvent &keyEvent, Window &window) {
+void handleKeyPressed(sf::Event::KeyEvent &keyEvent, Window &window, HUD &hud, Editor &editor, JumpControls &jumpControls) {
 	constexpr double visibleOffset = 1000;
 
+	if (jumpControls.onKeyPressed(keyEvent.code))
+		return;
+
 	switch (keyEvent.code) {
 	case sf::Keyboard::Up:
 		window.moveView(sf::Vector2f(0, -visibleOffset));
@@ -24,6 +29,34 @@ void handleKeyPressed(sf::Event::KeyEvent &keyEvent, Window &window) {
 	case sf::Keyboard::Left:
 		window.moveView(sf::Vector2f(-visibleOffset, 0));
 		break;
+
+	case sf::Keyboard::H:
+		hud.toggleVisible();
+		break;
+
+	case sf::Keyboard::P:
+		hud.toggleProfile();
+		break;
+
+	case sf::Keyboard::M:
+		hud.toggleMemory();
+		break;
+
+	case sf::Keyboard::T:
+		editor.setTool(Editor::toggle);
+		break;
+
+	case sf::Keyboard::F:
+		editor.setTool(Editor::fill);
+		break;
+
+	case sf::Keyboard::C:
+		editor.setTool(Editor::clear);
+		break;
+
+	case sf::Keyboard::V:
+		editor.setTool(Editor::paste);
+		break;
 	}
 }
 
@@ -31,7 +64,10 @@ void handleMouseWheelScroll(sf::Event::MouseWheelScrollEvent &mwScroll, Window &
 	window.zoom(sf::Vector2f(mwScroll.x, mwScroll.y), mwScroll.delta > 0);
 }
 
-void handleMouseButtonPressed(sf::Event::MouseButtonEvent mbE, Window &window, GUIs &guis, Cells &cells) {
+void handleMouseButtonPressed(sf::Event::MouseButtonEvent mbE, Window &window, GUIs &guis, Cells &cells, Editor &editor) {
+	if (cells.getJumping()) //Neither the buttons nor the editor work until the jump is finished or cancelled.
+		return;
+
 	bool guiPressed = false;
 
 	for (GUI &gui : guis) {
@@ -40,4 +76,17 @@ void handleMouseButtonPressed(sf::Event::MouseButtonEvent mbE, Window &window, G
 			guiPressed = true;
 		}
 	}
+
+	if (!guiPressed && mbE.button == sf::Mouse::Left && cells.getPause()) //Cells can only be edited while paused.
+		editor.onMousePressed(sf::Vector2i(mbE.x, mbE.y), window, cells);
+}
+
+void handleMouseButtonReleased(sf::Event::MouseButtonEvent mbE, Window &window, Cells &cells, Editor &editor) {
+	if (cells.getJumping()) { //A drag started before the jump is dropped.
+		editor.cancelDrag();
+		return;
+	}
+
+	if (mbE.button == sf::Mouse::Left)
+		editor.onMouseReleased(sf::Vector2i(mbE.x, mbE.y), window, cells);
 }
\ No newline at end of file
@@ -2,11 +2,14 @@
 #define HANDLEINPUT_H
 #include "Window.h"
 #include "GUI.h"
+#include "HUD.h"
+#include "Editor.h"
 
 #include <SFML/Graphics.hpp>
 
-void handleKeyPressed(sf::Event::KeyEvent &keyEvent, Window &window);
+void handleKeyPressed(sf::Event::KeyEvent &keyEvent, Window &window, HUD &hud, Editor &editor, JumpControls &jumpControls);
 void handleMouseWheelScroll(sf::Event::MouseWheelScrollEvent &mwScroll, Window &window);
-void handleMouseButtonPressed(sf::Event::MouseButtonEvent mbE, Window &window, GUIs &guis, Cells &cells);
+void handleMouseButtonPressed(sf::Event::MouseButtonEvent mbE, Window &window, GUIs &guis, Cells &cells, Editor &editor);
+void handleMouseButtonReleased(sf::Event::MouseButtonEvent mbE, Window &window, Cells &cells, Editor &editor);
 
 #endif
\ No newline at end of file
@@ -105,4 +105,20 @@ void HashTable<Key, T, HashFunctionObject>::rehash() {
 		}
 	}
 	*this = std::move(newHashTable);
+}
+
+template<typename Key, typename T, typename HashFunctionObject> typename HashTable<Key, T, HashFunctionObject>::reference HashTable<Key, T, HashFunctionObject>::iterator::operator*() {
+	return base[index];
+}
+
+template<typename Key, typename T, typename HashFunctionObject> typename const HashTable<Key, T, HashFunctionObject>::const_reference HashTable<Key, T, HashFunctionObject>::const_iterator::operator*() {
+	return base[index];
+}
+
+template<typename Key, typename T, typename HashFunctionObject> typename HashTable<Key, T, HashFunctionObject>::value_type *HashTable<Key, T, HashFunctionObject>::iterator::operator->() {
+	return &base[index];
+}
+
+template<typename Key, typename T, typename HashFunctionObject> typename const HashTable<Key, T, HashFunctionObject>::value_type *HashTable<Key, T, HashFunctionObject>::const_iterator::operator->() {
+	return &base[index];
 }
\ No newline at end of file
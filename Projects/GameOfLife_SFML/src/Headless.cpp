@@ -0,0 +1,119 @@
+#include "Headless.h"
+#include "Cell.h"
+#include "Options.h"
+#include "MemoryAccounting.h"
+#include "ObjectSeparation.h"
+#include "FrameExport.h"
+#include "PopulationIndex.h"
+
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+
+namespace {
+	constexpr std::size_t maxObjectKinds = 50; //Lines of the object census.
+}
+
+int runHeadless(Cells &cells, const Options &options) {
+	cells.setRecordHistory(false); //Nobody can rewind, so do not let history grow.
+	cells.setCycleDetection(true);
+
+	std::unique_ptr<FrameExporter> frameExporter;
+	if (!options.exportDirectory.empty()) {
+		Position topLeft = options.exportTopLeft, size = options.exportSize;
+		if (!size.x) //The map, as far as it is alive.
+			topLeft = cells.getStatistics().getBoundingBoxMin(), size = cells.getStatistics().getBoundingBoxMax() - topLeft + Position{ 1, 1 };
+		frameExporter = std::make_unique<FrameExporter>(options.exportDirectory, topLeft, size, options.exportScale, options.exportEvery, options.exportRaw, options.threads);
+		cells.addChangeListener(*frameExporter);
+		frameExporter->exportIfDue(cells.getGeneration());
+	}
+
+	std::unique_ptr<PopulationIndex> populationIndex;
+	Position countMin = options.countTopLeft, countMax = options.countTopLeft + options.countSize - Position{ 1, 1 };
+	Cells::generationType firstAliveInRegion = 0;
+	bool aliveInRegion = false;
+	if (options.countSize.x) {
+		populationIndex = std::make_unique<PopulationIndex>();
+		cells.addChangeListener(*populationIndex);
+		aliveInRegion = populationIndex->anyAlive(countMin, countMax);
+		firstAliveInRegion = cells.getGeneration();
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	CycleDetector::Cycle cycle; //Skipping ahead forgets the cycle, so keep the first one found.
+	bool skipped = false;
+
+	while (cells.getGeneration() < options.generations) {
+		cells.updateCells();
+		if (cells.getGeneration() % Cells::maintenanceInterval == 0)
+			cells.performMaintenance();
+		cells.autosaveIfDue();
+		if (frameExporter)
+			frameExporter->exportIfDue(cells.getGeneration());
+		if (populationIndex && !aliveInRegion && populationIndex->anyAlive(countMin, countMax)) {
+			aliveInRegion = true;
+			firstAliveInRegion = cells.getGeneration();
+		}
+
+		if (cells.getCycleDetector()->found()) {
+			if (!cycle.period)
+				cycle = cells.getCycleDetector()->getCycle();
+			if (options.stopOnCycle)
+				break;
+			if (!frameExporter && !populationIndex) //Every generation is exported or watched, so none can be skipped.
+				skipped = cells.skipCycles(options.generations) || skipped; //Only the remainder of a period is simulated afterwards.
+		}
+	}
+
+	auto timeTaken = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+	if (frameExporter) {
+		cells.removeChangeListener(*frameExporter);
+		frameExporter->finish();
+		Position imageSize = frameExporter->getImageSize();
+		std::cout << "Frames: " << frameExporter->getFramesWritten() << " of " << imageSize.x << "x" << imageSize.y << " pixels written to " << options.exportDirectory << (options.exportRaw ? " as frames.rgba\n" : "\n");
+	}
+
+	const WorldStatistics &statistics = cells.getStatistics();
+	Position boundingBoxMin = statistics.getBoundingBoxMin(), boundingBoxMax = statistics.getBoundingBoxMax();
+
+	std::cout << "Generation: " << cells.getGeneration() << "\n";
+	std::cout << "Alive cells: " << statistics.getPopulation() << "\n";
+	std::cout << "Bounding box: (" << boundingBoxMin.x << ", " << boundingBoxMin.y << ") to (" << boundingBoxMax.x << ", " << boundingBoxMax.y << ")\n";
+	std::cout << "Births/deaths in the last generation: " << statistics.getBirths() << "/" << statistics.getDeaths() << "\n";
+
+	WorldHash worldHash; //Also printed by --shards, so both can be compared.
+	cells.forEachAliveCell([&worldHash](Position pos) {
+		worldHash.update(pos, true);
+	});
+	std::cout << "World hash: " << std::hex << std::setw(16) << std::setfill('0') << worldHash.getHash() << std::dec << std::setfill(' ') << "\n";
+
+	if (populationIndex) {
+		std::cout << "Alive cells in (" << countMin.x << ", " << countMin.y << ") to (" << countMax.x << ", " << countMax.y << "): " << populationIndex->count(countMin, countMax);
+		if (aliveInRegion)
+			std::cout << ", first alive at generation " << firstAliveInRegion << "\n";
+		else
+			std::cout << ", never alive\n";
+		cells.removeChangeListener(*populationIndex);
+	}
+
+	if (cycle.period) {
+		std::cout << "Cycle: period " << cycle.period << ", displacement (" << cycle.displacement.x << ", " << cycle.displacement.y << "), detected at generation " << cycle.detectedAt;
+		std::cout << (skipped ? ", skipped ahead\n" : "\n");
+	}
+	else
+		std::cout << "Cycle: none found\n";
+
+	std::cout << "Time: " << timeTaken.count() << " ms\n";
+
+	std::cout << "Memory:\n";
+	writeMemoryReport(std::cout, cells);
+
+	objectCensusType census;
+	addToObjectCensus(census, ObjectSeparator()(cells), ObjectCatalogue(RuleMasks(cells.getRules().getTransitionTable())));
+	std::cout << "Objects:\n";
+	writeObjectCensus(std::cout, census, maxObjectKinds);
+
+	return 0;
+}
@@ -0,0 +1,9 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include "Cell.h"
+#include "Options.h"
+
+int runHeadless(Cells &cells, const Options &options); //Simulate options.generations generations without opening a window, then print a summary. Returns the exit code for main.
+
+#endif
@@ -0,0 +1,45 @@
+#include "MemoryAccounting.h"
+#include "Cell.h"
+
+#include <iomanip>
+
+std::array<MemoryAccounting::Counters, MemoryAccounting::tagCount> MemoryAccounting::counters;
+
+const char *MemoryAccounting::getTagName(Tag tag) {
+	switch (tag) {
+	case cells: return "cells";
+	case statistics: return "statistics";
+	case history: return "history";
+	case grid: return "grid";
+	case rendering: return "rendering";
+	case autosave: return "autosave";
+	case views: return "views";
+	case populationIndex: return "population index";
+	default: return "unknown";
+	}
+}
+
+std::size_t MemoryAccounting::getTotalBytes() noexcept {
+	std::size_t total = 0;
+	for (int tag = 0; tag < tagCount; ++tag)
+		total += getBytes(Tag(tag));
+	return total;
+}
+
+void writeMemoryReport(std::ostream &os, const Cells &cells) {
+	for (int tag = 0; tag < MemoryAccounting::tagCount; ++tag) {
+		os << MemoryAccounting::getTagName(MemoryAccounting::Tag(tag)) << ": " << MemoryAccounting::getBytes(MemoryAccounting::Tag(tag)) / 1024 << " KB in "
+			<< MemoryAccounting::getAllocations(MemoryAccounting::Tag(tag)) << " allocations\n";
+	}
+
+	std::size_t totalBytes = MemoryAccounting::getTotalBytes();
+	os << "total: " << totalBytes / 1024 << " KB";
+	if (cells.getStatistics().getPopulation())
+		os << ", " << totalBytes / cells.getStatistics().getPopulation() << " bytes per alive cell";
+	os << "\n";
+
+	if (!cells.getWrapAround()) {
+		os << "hash map: " << cells.size() << " cells in " << cells.getBucketCount() << " buckets, load factor "
+			<< std::fixed << std::setprecision(2) << cells.getLoadFactor() << std::defaultfloat << "\n";
+	}
+}
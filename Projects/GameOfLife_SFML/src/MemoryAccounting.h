@@ -0,0 +1,91 @@
+#ifndef MEMORYACCOUNTING_H
+#define MEMORYACCOUNTING_H
+
+#include <atomic>
+#include <array>
+#include <memory>
+#include <cstddef>
+#include <ostream>
+
+class Cells;
+
+class MemoryAccounting { //Bytes currently allocated by each subsystem, counted by TaggedAllocator. Shared by all worlds and threads.
+public:
+	enum Tag {
+		cells, //Nodes and buckets of the hash map of cells, including the neighbor positions stored in each cell.
+		statistics, //Alive cells per row and column.
+		history, //Changes recorded for rewinding, and the changes of the last tick.
+		grid, //The buffers of a world that wraps around.
+		rendering, //Vertex buffers.
+		autosave, //Changes waiting for the autosave thread, and its copy of the alive cells.
+		views, //Alive cells gathered for programs that embed the simulation.
+		populationIndex, //The chunks and quadtree levels that count the alive cells in rectangles.
+		tagCount
+	};
+
+	static const char *getTagName(Tag tag);
+
+	static void allocated(Tag tag, std::size_t bytes) noexcept {
+		counters[tag].bytes.fetch_add(bytes, std::memory_order_relaxed);
+		counters[tag].allocations.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	static void deallocated(Tag tag, std::size_t bytes) noexcept {
+		counters[tag].bytes.fetch_sub(bytes, std::memory_order_relaxed);
+		counters[tag].allocations.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	static std::size_t getBytes(Tag tag) noexcept {
+		return counters[tag].bytes.load(std::memory_order_relaxed);
+	}
+
+	static std::size_t getAllocations(Tag tag) noexcept { //Live allocations, not allocations made so far.
+		return counters[tag].allocations.load(std::memory_order_relaxed);
+	}
+
+	static std::size_t getTotalBytes() noexcept;
+
+private:
+	class Counters {
+	public:
+		std::atomic<std::size_t> bytes{ 0 };
+		std::atomic<std::size_t> allocations{ 0 };
+	};
+
+	static std::array<Counters, tagCount> counters;
+};
+
+template<typename T, MemoryAccounting::Tag tag>
+class TaggedAllocator { //std::allocator that reports every allocation to MemoryAccounting under tag.
+public:
+	typedef T value_type;
+
+	template<typename U> struct rebind {
+		typedef TaggedAllocator<U, tag> other;
+	};
+
+	TaggedAllocator() noexcept = default;
+	template<typename U> TaggedAllocator(const TaggedAllocator<U, tag>&) noexcept {}
+
+	T *allocate(std::size_t n) {
+		T *result = std::allocator<T>().allocate(n);
+		MemoryAccounting::allocated(tag, n * sizeof(T));
+		return result;
+	}
+
+	void deallocate(T *ptr, std::size_t n) noexcept {
+		MemoryAccounting::deallocated(tag, n * sizeof(T));
+		std::allocator<T>().deallocate(ptr, n);
+	}
+
+	friend bool operator==(const TaggedAllocator&, const TaggedAllocator&) noexcept {
+		return true;
+	}
+	friend bool operator!=(const TaggedAllocator&, const TaggedAllocator&) noexcept {
+		return false;
+	}
+};
+
+void writeMemoryReport(std::ostream &os, const Cells &cells); //Memory used by each subsystem, per alive cell, and how full the hash map of cells is.
+
+#endif
\ No newline at end of file
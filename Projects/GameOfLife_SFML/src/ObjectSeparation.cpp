@@ -0,0 +1,366 @@
+#include "ObjectSeparation.h"
+#include "FileProcessing.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <thread>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <unordered_set>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace {
+	class KnownObject {
+	public:
+		const char *name;
+		CycleDetector::generationType period;
+		const char *pattern; //In the format of map files.
+	};
+
+	const KnownObject knownObjects[] = { //Life (B3/S23).
+		{ "block", 1, "**\n**" },
+		{ "beehive", 1, " ** \n*  *\n ** " },
+		{ "loaf", 1, " ** \n*  *\n * *\n  * " },
+		{ "boat", 1, "** \n* *\n * " },
+		{ "ship", 1, "** \n* *\n **" },
+		{ "tub", 1, " * \n* *\n * " },
+		{ "pond", 1, " ** \n*  *\n*  *\n ** " },
+		{ "long boat", 1, "**  \n* * \n * *\n  * " },
+		{ "barge", 1, " *  \n* * \n * *\n  * " },
+		{ "mango", 1, " **  \n*  * \n *  *\n  ** " },
+		{ "eater", 1, "**  \n* * \n  * \n  **" },
+		{ "snake", 1, "** *\n* **" },
+		{ "aircraft carrier", 1, "**  \n*  *\n  **" },
+		{ "blinker", 2, "***" },
+		{ "toad", 2, " ***\n*** " },
+		{ "beacon", 2, "**  \n**  \n  **\n  **" },
+		{ "traffic light", 2, "  ***  \n       \n*     *\n*     *\n*     *\n       \n  ***  " },
+		{ "pulsar", 3, "  ***   ***  \n             \n*    * *    *\n*    * *    *\n*    * *    *\n  ***   ***  \n             \n  ***   ***  \n*    * *    *\n*    * *    *\n*    * *    *\n             \n  ***   ***  " },
+		{ "pentadecathlon", 15, "  *    *  \n** **** **\n  *    *  " },
+		{ "glider", 4, " * \n  *\n***" },
+		{ "lightweight spaceship", 4, " *  *\n*    \n*   *\n**** " },
+		{ "middleweight spaceship", 4, "   *  \n *   *\n*     \n*    *\n***** " },
+		{ "heavyweight spaceship", 4, "   **  \n *    *\n*      \n*     *\n****** " }
+	};
+
+	constexpr std::size_t maxCatalogueObjectSize = 1000; //Patterns that grow beyond this under other rules are left out of the catalogue.
+
+	objectType stepObject(const objectType &object, const RuleMasks &rules) { //One generation of an object on its own.
+		std::unordered_map<Position, int, MortonHasher> aliveNeighbors;
+		std::unordered_set<Position, MortonHasher> alive(object.begin(), object.end());
+
+		for (Position pos : object) {
+			aliveNeighbors[pos]; //So lonely cells are evaluated as well.
+			for (Position::coordType y = -1; y <= 1; ++y) {
+				for (Position::coordType x = -1; x <= 1; ++x) {
+					if (x || y)
+						++aliveNeighbors[pos + Position{ x, y }];
+				}
+			}
+		}
+
+		objectType next;
+		for (auto &pair : aliveNeighbors) {
+			if ((((alive.count(pair.first) ? rules.survival : rules.birth) >> pair.second) & 1))
+				next.push_back(pair.first);
+		}
+		return next;
+	}
+
+	objectType normalize(objectType object) { //Sorted and moved so its bounding box starts at (0, 0). Equal for translated copies of an object.
+		Position topLeft{ std::numeric_limits<Position::coordType>::max(), std::numeric_limits<Position::coordType>::max() };
+		for (Position pos : object) {
+			topLeft.x = std::min(topLeft.x, pos.x);
+			topLeft.y = std::min(topLeft.y, pos.y);
+		}
+
+		for (Position &pos : object)
+			pos = pos - topLeft;
+		std::sort(object.begin(), object.end(), [](Position pos1, Position pos2) {
+			return pos1.y < pos2.y || (pos1.y == pos2.y && pos1.x < pos2.x);
+		});
+		return object;
+	}
+}
+
+ObjectSeparator::ObjectSeparator(unsigned tc) : threadCount{ tc ? tc : std::max(std::thread::hardware_concurrency(), 1u) } {}
+
+template<typename F> void ObjectSeparator::runInParallel(std::size_t count, F f) {
+	std::size_t usedThreads = std::min<std::size_t>(threadCount, count);
+	if (usedThreads <= 1) {
+		f(std::size_t(0), std::size_t(0), count);
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	for (std::size_t thread = 0; thread < usedThreads; ++thread)
+		threads.emplace_back(f, thread, count * thread / usedThreads, count * (thread + 1) / usedThreads);
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
+std::vector<objectType> ObjectSeparator::operator()(const Cells &cells) {
+	TRACE_SCOPE("object separation");
+
+	sortedCells.clear();
+	cells.forEachAliveCell([this](Position pos) {
+		sortedCells.emplace_back(MortonHasher::getKey(pos), pos);
+	});
+	if (sortedCells.size() >= none)
+		throw(std::logic_error("Too many alive cells to separate into objects."));
+
+	//Sort parts of the cells in parallel, then merge the parts.
+	auto byKey = [](const std::pair<std::uint64_t, Position> &cell1, const std::pair<std::uint64_t, Position> &cell2) {
+		return cell1.first < cell2.first;
+	};
+	std::size_t partCount = std::min<std::size_t>(threadCount, sortedCells.size() / 4096 + 1);
+	runInParallel(partCount, [&](std::size_t, std::size_t firstPart, std::size_t lastPart) {
+		std::sort(sortedCells.begin() + sortedCells.size() * firstPart / partCount, sortedCells.begin() + sortedCells.size() * lastPart / partCount, byKey);
+	});
+	for (std::size_t width = 1; width < partCount; width *= 2) {
+		for (std::size_t part = 0; part + width < partCount; part += 2 * width) {
+			auto first = sortedCells.begin() + sortedCells.size() * part / partCount;
+			auto middle = sortedCells.begin() + sortedCells.size() * (part + width) / partCount;
+			auto last = sortedCells.begin() + sortedCells.size() * std::min(part + 2 * width, partCount) / partCount;
+			std::inplace_merge(first, middle, last, byKey);
+		}
+	}
+
+	chunkBegins.clear();
+	for (std::size_t cell = 0; cell < sortedCells.size(); ++cell) {
+		if (!cell || (sortedCells[cell].first >> (2 * chunkBits)) != (sortedCells[cell - 1].first >> (2 * chunkBits)))
+			chunkBegins.push_back(cell);
+	}
+	chunkBegins.push_back(sortedCells.size());
+	std::size_t chunkCount = chunkBegins.size() - 1;
+
+	parents.resize(sortedCells.size());
+	std::iota(parents.begin(), parents.end(), indexType(0));
+
+	runInParallel(chunkCount, [this](std::size_t, std::size_t firstChunk, std::size_t lastChunk) {
+		labelChunks(firstChunk, lastChunk);
+	});
+
+	borderPairs.resize(threadCount);
+	runInParallel(chunkCount, [this](std::size_t thread, std::size_t firstChunk, std::size_t lastChunk) {
+		borderPairs[thread].clear();
+		findBorderPairs(firstChunk, lastChunk, borderPairs[thread]);
+	});
+	for (std::size_t thread = 0; thread < std::min<std::size_t>(threadCount, chunkCount); ++thread) { //Merging across chunks is done by one thread.
+		for (auto &pair : borderPairs[thread])
+			unite(pair.first, pair.second);
+	}
+
+	roots.resize(sortedCells.size());
+	runInParallel(chunkCount, [this](std::size_t, std::size_t firstChunk, std::size_t lastChunk) { //Nothing is united anymore, so following parents without compressing paths is safe.
+		for (std::size_t cell = chunkBegins[firstChunk]; cell < chunkBegins[lastChunk]; ++cell) {
+			indexType root = indexType(cell);
+			while (parents[root] != root)
+				root = parents[root];
+			roots[cell] = root;
+		}
+	});
+
+	//Number the objects in the order their roots appear, and count their cells first, so each object is allocated once.
+	std::vector<indexType> objectIndices(sortedCells.size(), none), objectSizes;
+	for (std::size_t cell = 0; cell < sortedCells.size(); ++cell) {
+		indexType &objectIndex = objectIndices[roots[cell]];
+		if (objectIndex == none) {
+			objectIndex = indexType(objectSizes.size());
+			objectSizes.push_back(0);
+		}
+		++objectSizes[objectIndex];
+	}
+
+	std::vector<objectType> objects(objectSizes.size());
+	for (std::size_t object = 0; object < objects.size(); ++object)
+		objects[object].reserve(objectSizes[object]);
+	for (std::size_t cell = 0; cell < sortedCells.size(); ++cell)
+		objects[objectIndices[roots[cell]]].push_back(sortedCells[cell].second);
+
+	return objects;
+}
+
+void ObjectSeparator::labelChunks(std::size_t firstChunk, std::size_t lastChunk) {
+	std::vector<indexType> grid(chunkSize * chunkSize, none); //The cell at each position of the current chunk.
+
+	for (std::size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+		for (std::size_t cell = chunkBegins[chunk]; cell < chunkBegins[chunk + 1]; ++cell) {
+			Position pos = sortedCells[cell].second;
+			grid[(pos.y & (chunkSize - 1)) * chunkSize + (pos.x & (chunkSize - 1))] = indexType(cell);
+		}
+
+		for (std::size_t cell = chunkBegins[chunk]; cell < chunkBegins[chunk + 1]; ++cell) {
+			Position pos = sortedCells[cell].second;
+			for (Position::coordType y = -interactionDistance; y <= 0; ++y) { //Half of the surrounding positions, so each pair is only looked at once.
+				for (Position::coordType x = -interactionDistance; x <= (y ? interactionDistance : -1); ++x) {
+					Position neighborPos = pos + Position{ x, y };
+					if (!sameChunk(pos, neighborPos))
+						continue;
+
+					indexType neighbor = grid[(neighborPos.y & (chunkSize - 1)) * chunkSize + (neighborPos.x & (chunkSize - 1))];
+					if (neighbor != none)
+						unite(indexType(cell), neighbor);
+				}
+			}
+		}
+
+		for (std::size_t cell = chunkBegins[chunk]; cell < chunkBegins[chunk + 1]; ++cell) {
+			Position pos = sortedCells[cell].second;
+			grid[(pos.y & (chunkSize - 1)) * chunkSize + (pos.x & (chunkSize - 1))] = none;
+		}
+	}
+}
+
+void ObjectSeparator::findBorderPairs(std::size_t firstChunk, std::size_t lastChunk, cellPairContainerType &pairs) const {
+	for (std::size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+		std::array<std::pair<std::size_t, std::size_t>, 9> neighborChunks; //The cells of the surrounding chunks, by (y + 1) * 3 + x + 1. Looked up when first needed.
+		std::array<bool, 9> neighborChunksFound{};
+
+		for (std::size_t cell = chunkBegins[chunk]; cell < chunkBegins[chunk + 1]; ++cell) {
+			Position pos = sortedCells[cell].second;
+			Position::coordType chunkX = pos.x & (chunkSize - 1), chunkY = pos.y & (chunkSize - 1);
+			if (chunkX >= interactionDistance && chunkY >= interactionDistance && chunkX < chunkSize - interactionDistance) //The half of the surrounding positions looked at cannot reach another chunk.
+				continue;
+
+			for (Position::coordType y = -interactionDistance; y <= 0; ++y) {
+				for (Position::coordType x = -interactionDistance; x <= (y ? interactionDistance : -1); ++x) {
+					Position neighborPos = pos + Position{ x, y };
+					if (sameChunk(pos, neighborPos))
+						continue;
+
+					std::size_t neighborChunk = ((neighborPos.y >> chunkBits) - (pos.y >> chunkBits) + 1) * 3 + (neighborPos.x >> chunkBits) - (pos.x >> chunkBits) + 1;
+					if (!neighborChunksFound[neighborChunk]) {
+						neighborChunks[neighborChunk] = getChunkCells(neighborPos);
+						neighborChunksFound[neighborChunk] = true;
+					}
+
+					std::uint64_t key = MortonHasher::getKey(neighborPos);
+					auto first = sortedCells.begin() + neighborChunks[neighborChunk].first, last = sortedCells.begin() + neighborChunks[neighborChunk].second;
+					auto it = std::lower_bound(first, last, key, [](const std::pair<std::uint64_t, Position> &sortedCell, std::uint64_t k) {
+						return sortedCell.first < k;
+					});
+					if (it != last && it->first == key)
+						pairs.emplace_back(indexType(cell), indexType(it - sortedCells.begin()));
+				}
+			}
+		}
+	}
+}
+
+std::pair<std::size_t, std::size_t> ObjectSeparator::getChunkCells(Position pos) const {
+	std::uint64_t chunkKey = MortonHasher::getKey(pos) >> (2 * chunkBits);
+	auto it = std::lower_bound(chunkBegins.begin(), chunkBegins.end() - 1, chunkKey, [this](std::size_t chunkBegin, std::uint64_t k) {
+		return (sortedCells[chunkBegin].first >> (2 * chunkBits)) < k;
+	});
+
+	if (it == chunkBegins.end() - 1 || (sortedCells[*it].first >> (2 * chunkBits)) != chunkKey)
+		return std::make_pair(std::size_t(0), std::size_t(0));
+	return std::make_pair(*it, *(it + 1));
+}
+
+ObjectSeparator::indexType ObjectSeparator::find(indexType cell) {
+	while (parents[cell] != cell) {
+		parents[cell] = parents[parents[cell]];
+		cell = parents[cell];
+	}
+	return cell;
+}
+
+void ObjectSeparator::unite(indexType cell1, indexType cell2) {
+	indexType root1 = find(cell1), root2 = find(cell2);
+	if (root1 < root2) //The lower index becomes the root, so roots within a chunk stay within it.
+		parents[root2] = root1;
+	else if (root2 < root1)
+		parents[root1] = root2;
+}
+
+ObjectCatalogue::ObjectCatalogue(const RuleMasks &rules) {
+	if (rules.birth & 1) //Empty space comes to life, so nothing is an object on its own.
+		return;
+
+	std::vector<objectType> objectPhases;
+	for (const KnownObject &knownObject : knownObjects) {
+		objectType object;
+		for (auto &cell : getPatternFromStr(knownObject.pattern)) {
+			if (cell.second)
+				object.push_back(cell.first);
+		}
+
+		objectPhases.clear();
+		bool periodic = true;
+		for (CycleDetector::generationType phase = 0; phase < knownObject.period && periodic; ++phase) {
+			objectPhases.push_back(normalize(object));
+			object = stepObject(object, rules);
+			periodic = !object.empty() && object.size() <= maxCatalogueObjectSize && (phase + 1 == knownObject.period) == (normalize(object) == objectPhases.front()); //Back to the first phase after exactly one period.
+		}
+		if (!periodic)
+			continue;
+
+		for (const objectType &objectPhase : objectPhases)
+			phases.emplace(getCanonicalHash(objectPhase), Entry{ knownObject.name, knownObject.period });
+		++objectCount;
+	}
+}
+
+ObjectCatalogue::hashType ObjectCatalogue::getCanonicalHash(const objectType &object) {
+	hashType canonicalHash = std::numeric_limits<hashType>::max();
+
+	objectType transformed(object.size());
+	for (int transformation = 0; transformation < 8; ++transformation) { //Bit 0 swaps x and y, bit 1 mirrors x, bit 2 mirrors y.
+		for (std::size_t cell = 0; cell < object.size(); ++cell) {
+			Position pos = object[cell];
+			if (transformation & 1)
+				std::swap(pos.x, pos.y);
+			if (transformation & 2)
+				pos.x = -pos.x;
+			if (transformation & 4)
+				pos.y = -pos.y;
+			transformed[cell] = pos;
+		}
+		transformed = normalize(std::move(transformed));
+
+		hashType hash = 14695981039346656037ull; //FNV-1a.
+		for (Position pos : transformed) {
+			hash = (hash ^ static_cast<std::uint32_t>(pos.x)) * 1099511628211ull;
+			hash = (hash ^ static_cast<std::uint32_t>(pos.y)) * 1099511628211ull;
+		}
+		canonicalHash = std::min(canonicalHash, hash);
+	}
+
+	return canonicalHash;
+}
+
+const ObjectCatalogue::Entry *ObjectCatalogue::find(const objectType &object) const {
+	auto it = phases.find(getCanonicalHash(object));
+	return it != phases.end() ? &it->second : nullptr;
+}
+
+std::string ObjectCatalogue::getName(const objectType &object) const {
+	if (const Entry *entry = find(object))
+		return entry->name;
+
+	std::ostringstream name;
+	name << "unknown, " << object.size() << " cells, " << std::hex << std::setw(16) << std::setfill('0') << getCanonicalHash(object);
+	return name.str();
+}
+
+void addToObjectCensus(objectCensusType &census, const std::vector<objectType> &objects, const ObjectCatalogue &catalogue) {
+	for (const objectType &object : objects)
+		++census[catalogue.getName(object)];
+}
+
+void writeObjectCensus(std::ostream &os, const objectCensusType &census, std::size_t maxKinds) {
+	std::vector<std::pair<std::string, unsigned long long>> sorted(census.begin(), census.end());
+	std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, unsigned long long> &entry1, const std::pair<std::string, unsigned long long> &entry2) {
+		return entry1.second > entry2.second;
+	});
+
+	for (std::size_t kind = 0; kind < sorted.size() && kind < maxKinds; ++kind)
+		os << "  " << sorted[kind].first << ": " << sorted[kind].second << "\n";
+	if (sorted.size() > maxKinds)
+		os << "  and " << sorted.size() - maxKinds << " other kinds of objects\n";
+}
@@ -0,0 +1,90 @@
+#ifndef OBJECTSEPARATION_H
+#define OBJECTSEPARATION_H
+
+#include "Cell.h"
+#include "RuleKernels.h"
+#include "CycleDetection.h"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+//Splitting the alive cells of a world into separate objects, and naming them.
+
+typedef std::vector<Position> objectType; //The alive cells of one object.
+
+class ObjectSeparator { //Connected-component labeling with union-find. Alive cells within interactionDistance of each other belong to the same object.
+public:
+	static constexpr Position::coordType interactionDistance = 2; //Cells further apart have no neighbor in common, so they cannot affect each other in the next generation.
+	static constexpr int chunkBits = 6; //Cells are first labeled within chunks of 64x64 cells, spread over the threads, and then merged across chunk borders.
+
+	explicit ObjectSeparator(unsigned threadCount = 0); //0 uses every core.
+
+	std::vector<objectType> operator()(const Cells &cells); //In a world that wraps around, objects crossing an edge are split in two.
+
+private:
+	typedef std::uint32_t indexType; //Of a cell in sortedCells.
+
+	static constexpr indexType none = ~indexType(0);
+	static constexpr Position::coordType chunkSize = 1 << chunkBits;
+
+	typedef std::vector<std::pair<indexType, indexType>> cellPairContainerType;
+
+	template<typename F> void runInParallel(std::size_t count, F f); //Splits [0, count) into one range per thread and calls f(thread, first, last) for each range at the same time.
+
+	void labelChunks(std::size_t firstChunk, std::size_t lastChunk); //Only touches the parents of cells in these chunks, so threads do not get in each other's way.
+	void findBorderPairs(std::size_t firstChunk, std::size_t lastChunk, cellPairContainerType &pairs) const; //Cells of these chunks that are close to a cell in another chunk. Only reads, so threads can look at the borders of different chunks at the same time.
+	std::pair<std::size_t, std::size_t> getChunkCells(Position pos) const; //The range of sortedCells in the chunk of pos. Empty if it has no alive cells.
+
+	indexType find(indexType cell); //With path halving.
+	void unite(indexType cell1, indexType cell2);
+
+	static bool sameChunk(Position pos1, Position pos2) {
+		return (pos1.x >> chunkBits) == (pos2.x >> chunkBits) && (pos1.y >> chunkBits) == (pos2.y >> chunkBits);
+	}
+
+	std::vector<std::pair<std::uint64_t, Position>> sortedCells; //Alive cells by Z-order (Morton) key, so each chunk is a contiguous range.
+	std::vector<std::size_t> chunkBegins; //Index of the first cell of each chunk, followed by the amount of cells.
+	std::vector<indexType> parents;
+	std::vector<indexType> roots; //Of each cell, once all cells are merged.
+	std::vector<cellPairContainerType> borderPairs; //Found by each thread.
+	unsigned threadCount;
+};
+
+class ObjectCatalogue { //Known still lifes, oscillators and spaceships, recognised in every phase, rotation, reflection and position.
+public:
+	typedef std::uint64_t hashType;
+
+	class Entry {
+	public:
+		std::string name;
+		CycleDetector::generationType period;
+	};
+
+	explicit ObjectCatalogue(const RuleMasks &rules); //Only objects that still have their catalogued period under these rules are included.
+
+	static hashType getCanonicalHash(const objectType &object); //The same for each rotation, reflection and translation of an object.
+
+	const Entry *find(const objectType &object) const; //nullptr if the object is not known.
+	std::string getName(const objectType &object) const; //The name in the catalogue, or the size and canonical hash of an unknown object.
+
+	std::size_t size() const noexcept { //Amount of objects, not of phases.
+		return objectCount;
+	}
+
+private:
+	std::unordered_map<hashType, Entry> phases; //By the canonical hash of each phase of each object.
+	std::size_t objectCount{ 0 };
+};
+
+typedef std::map<std::string, unsigned long long> objectCensusType; //Amount of objects with each name.
+
+void addToObjectCensus(objectCensusType &census, const std::vector<objectType> &objects, const ObjectCatalogue &catalogue);
+void writeObjectCensus(std::ostream &os, const objectCensusType &census, std::size_t maxKinds); //The maxKinds most common objects, most common first.
+
+#endif
\ No newline at end of file
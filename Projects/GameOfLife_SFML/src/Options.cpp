@@ -0,0 +1,160 @@
+#include "Options.h"
+
+#include <string>
+#include <stdexcept>
+#include <sstream>
+
+Options::Options(int argc, char **argv) {
+	if (argc < 3)
+		throw(std::invalid_argument("At least 2 arguments (the rules file and the map file) must be provided to the program."));
+
+	rulesFilePath = argv[1];
+
+	int firstFlag = 2;
+	if (std::string(argv[2]).compare(0, 2, "--") != 0) //Some modes may leave out the map file, which is checked below.
+		mapFilePath = argv[firstFlag++];
+
+	for (int i = firstFlag; i < argc; ++i) {
+		std::string flag = argv[i];
+
+		if (flag == "--wrap")
+			wrapAround = true;
+		else if (flag == "--stop-on-cycle")
+			stopOnCycle = true;
+		else if (flag == "--z-order")
+			zOrder = true;
+		else if (flag == "--benchmark")
+			benchmark = true;
+		else if (flag == "--resume")
+			resume = true;
+		else if (flag == "--profile-csv") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--profile-csv must be followed by a file path."));
+			profileCSVFilePath = argv[++i];
+		}
+		else if (flag == "--trace") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--trace must be followed by a file path."));
+			traceFilePath = argv[++i];
+		}
+		else if (flag == "--pattern") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--pattern must be followed by a file path."));
+			patternFilePath = argv[++i];
+		}
+		else if (flag == "--generations") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--generations must be followed by the amount of generations."));
+			generations = std::stoull(argv[++i]);
+		}
+		else if (flag == "--soup-search") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--soup-search must be followed by the amount of soups."));
+			soupSearch = std::stoull(argv[++i]);
+		}
+		else if (flag == "--seed") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--seed must be followed by a number."));
+			seed = std::stoull(argv[++i]);
+			seedGiven = true;
+		}
+		else if (flag == "--threads") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--threads must be followed by the amount of threads."));
+			threads = static_cast<unsigned>(std::stoul(argv[++i]));
+		}
+		else if (flag == "--compare") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--compare must be followed by two engines, such as reference,hashed."));
+			compareEngines = argv[++i];
+		}
+		else if (flag == "--corpus") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--corpus must be followed by a directory."));
+			corpusPath = argv[++i];
+		}
+		else if (flag == "--golden") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--golden must be followed by a file path."));
+			goldenFilePath = argv[++i];
+		}
+		else if (flag == "--shards") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--shards must be followed by the amount of processes."));
+			shards = static_cast<unsigned>(std::stoul(argv[++i]));
+		}
+		else if (flag == "--autosave") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--autosave must be followed by a file path."));
+			autosaveFilePath = argv[++i];
+		}
+		else if (flag == "--autosave-interval") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--autosave-interval must be followed by the amount of seconds."));
+			autosaveInterval = std::stoul(argv[++i]);
+		}
+		else if (flag == "--export") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--export must be followed by a directory."));
+			exportDirectory = argv[++i];
+		}
+		else if (flag == "--export-every") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--export-every must be followed by the amount of generations."));
+			exportEvery = std::stoull(argv[++i]);
+			if (!exportEvery)
+				throw(std::invalid_argument("--export-every must be positive."));
+		}
+		else if (flag == "--export-region") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--export-region must be followed by X,Y,W,H."));
+			char separator1 = 0, separator2 = 0, separator3 = 0;
+			std::istringstream region(argv[++i]);
+			region >> exportTopLeft.x >> separator1 >> exportTopLeft.y >> separator2 >> exportSize.x >> separator3 >> exportSize.y;
+			if (!region || separator1 != ',' || separator2 != ',' || separator3 != ',' || exportSize.x <= 0 || exportSize.y <= 0)
+				throw(std::invalid_argument("--export-region must be followed by X,Y,W,H, with a positive width and height."));
+		}
+		else if (flag == "--count-region") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--count-region must be followed by X,Y,W,H."));
+			char separator1 = 0, separator2 = 0, separator3 = 0;
+			std::istringstream region(argv[++i]);
+			region >> countTopLeft.x >> separator1 >> countTopLeft.y >> separator2 >> countSize.x >> separator3 >> countSize.y;
+			if (!region || separator1 != ',' || separator2 != ',' || separator3 != ',' || countSize.x <= 0 || countSize.y <= 0)
+				throw(std::invalid_argument("--count-region must be followed by X,Y,W,H, with a positive width and height."));
+		}
+		else if (flag == "--export-scale") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--export-scale must be followed by the size of a cell in pixels."));
+			exportScale = std::stoi(argv[++i]);
+			if (exportScale <= 0)
+				throw(std::invalid_argument("--export-scale must be positive."));
+		}
+		else if (flag == "--export-raw")
+			exportRaw = true;
+		else if (flag == "--soup-size") {
+			if (i + 1 == argc)
+				throw(std::invalid_argument("--soup-size must be followed by the width of a soup."));
+			soupSize = std::stoi(argv[++i]);
+			if (soupSize <= 0)
+				throw(std::invalid_argument("--soup-size must be positive."));
+		}
+		else
+			throw(std::invalid_argument("Unknown option '" + flag + "'."));
+	}
+
+	if (mapFilePath.empty() && !soupSearch && corpusPath.empty())
+		throw(std::invalid_argument("A map file must be provided, unless --soup-search or --corpus is used."));
+	if ((!corpusPath.empty() || !goldenFilePath.empty()) && compareEngines.empty())
+		throw(std::invalid_argument("--corpus and --golden can only be used with --compare."));
+	if (shards && !generations)
+		throw(std::invalid_argument("--shards only runs without a window, so it needs --generations."));
+	if (!exportDirectory.empty() && (!generations || shards))
+		throw(std::invalid_argument("--export needs --generations, and cannot be combined with --shards."));
+	if (countSize.x && (!generations || shards))
+		throw(std::invalid_argument("--count-region needs --generations, and cannot be combined with --shards."));
+	if (shards && wrapAround)
+		throw(std::invalid_argument("--shards cannot be combined with --wrap."));
+	if (resume && (soupSearch || !compareEngines.empty() || shards || wrapAround))
+		throw(std::invalid_argument("--resume cannot be combined with --soup-search, --compare or --shards, and takes the size of a world that wraps around from the state file instead of --wrap."));
+}
@@ -0,0 +1,43 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include "Position.h"
+
+#include <string>
+
+class Options { //Command line options. The rules file and the map file come first, optional flags follow. A soup search or an engine comparison needs no map file.
+public:
+	Options(int argc, char **argv);
+	Options() = default;
+
+	std::string rulesFilePath;
+	std::string mapFilePath;
+	bool wrapAround = false; //--wrap: the world is the size of the map and its edges wrap around. (Extension 2)
+	unsigned long long generations = 0; //--generations N: simulate N generations without a window and print a summary. 0 opens the window instead.
+	std::string profileCSVFilePath; //--profile-csv FILE: write the duration of every timed phase to a CSV file.
+	std::string traceFilePath; //--trace FILE: record a timeline of ticks, frames, maintenance and history operations, viewable in Perfetto.
+	std::string patternFilePath; //--pattern FILE: the map the paste tool places.
+	bool zOrder = false; //--z-order: store cells in Z-order (Morton) so that cells close together are close together in memory.
+	bool benchmark = false; //--benchmark: compare the hashed and Z-order layouts over options.generations generations (or 1000) and exit.
+	bool stopOnCycle = false; //--stop-on-cycle: stop (or pause) once the world repeats itself, instead of skipping ahead to the requested generation.
+	unsigned long long soupSearch = 0; //--soup-search N: run N random soups until they stabilize and print a census of the results, without a window.
+	unsigned long long seed = 0; //--seed S: soup i is generated from seed S + i. Random if not given.
+	bool seedGiven = false;
+	unsigned threads = 0; //--threads N: threads used by the soup search. 0 uses every core.
+	int soupSize = 16; //--soup-size N: width and height of each soup.
+	std::string compareEngines; //--compare A,B: run two engines side by side on the map, or on a corpus, and stop at the first generation in which they differ.
+	std::string corpusPath; //--corpus DIR: with --compare, also use every rules file in DIR/Rules, every map in DIR/Patterns, DIR/map.txt and seeded soups.
+	std::string goldenFilePath; //--golden FILE: with --compare, check the final world hash of each case against FILE. FILE is written if it does not exist.
+	std::string autosaveFilePath; //--autosave FILE: periodically write the world to FILE as a map, from a background thread.
+	unsigned long autosaveInterval = 60; //--autosave-interval N: seconds between autosaves.
+	bool resume = false; //--resume: the map file was written by --autosave. Its state file replaces the rules file and restores the generation and the position of the cells.
+	std::string exportDirectory; //--export DIR: with --generations, write frames of the run to DIR as PNG images.
+	unsigned long long exportEvery = 1; //--export-every N: write every Nth generation.
+	Position exportTopLeft, exportSize; //--export-region X,Y,W,H: the cells that are written. A size of (0, 0) uses the bounding box of the map.
+	int exportScale = 4; //--export-scale N: width and height of a cell in pixels.
+	bool exportRaw = false; //--export-raw: append raw RGBA frames to DIR/frames.rgba instead, for a video encoder.
+	Position countTopLeft, countSize; //--count-region X,Y,W,H: with --generations, watch the alive cells in a rectangle. A size of (0, 0) watches none.
+	unsigned shards = 0; //--shards N: with --generations, split the world into N stripes of rows, each simulated by its own process. (Linux only)
+};
+
+#endif
@@ -10,34 +10,49 @@
 #include <memory>
 
 Cell &Parser::operator()(Cell &cell, Cells &cells) { //Apply rules to the cell. (set futures)
+	const bool alive = cell.getAlive();
+	const int aliveNeighbors = static_cast<int>(aliveNeighborCount(cell, cells)); //Neighbors do not change while the rules are evaluated, so count them once.
+
+	bool future = cell.getFutureAlive();
 	for (auto &tree : parseTrees) {
-		evaluateRulesAndSetFuture(cell, cells, *tree);
+		future = evaluateFuture(alive, aliveNeighbors, future, *tree);
 	}
+	cell.setFutureAlive(future);
+
 	return cell;
 }
 
 Cell &Parser::evaluateRulesAndSetFuture(Cell &cell, Cells &cells, BinaryParseTree &bpt) {
+	cell.setFutureAlive(evaluateFuture(cell.getAlive(), static_cast<int>(aliveNeighborCount(cell, cells)), cell.getFutureAlive(), bpt));
+	return cell;
+}
+
+bool Parser::conditional(Cell &cell, Cells &cells, BinaryParseTree &bpt) { //Evaluate a condition.
+	return conditional(cell.getAlive(), static_cast<int>(aliveNeighborCount(cell, cells)), bpt);
+}
+
+bool Parser::evaluateFuture(bool alive, int aliveNeighbors, bool future, BinaryParseTree &bpt) { //Returns the future of a cell after evaluating a single expression.
 	if (bpt.token.name == Token::arrowKeyword) {
-		if (conditional(cell, cells, bpt)) {
-			evaluateRulesAndSetFuture(cell, cells, *bpt.getRightChild());
+		if (conditional(alive, aliveNeighbors, bpt)) {
+			return evaluateFuture(alive, aliveNeighbors, future, *bpt.getRightChild());
 		}
 	}
 	else if (bpt.token.name == Token::ifnisKeyword) {
-		if (conditional(cell, cells, bpt)) {
-			evaluateRulesAndSetFuture(cell, cells, *bpt.getRightChild());
+		if (conditional(alive, aliveNeighbors, bpt)) {
+			return evaluateFuture(alive, aliveNeighbors, future, *bpt.getRightChild());
 		}
 	}
 	else if (bpt.token.name == Token::aliveKeyword) {
-		cell.setFutureAlive(true);
+		return true;
 	}
 	else if (bpt.token.name == Token::deadKeyword) {
-		cell.setFutureAlive(false);
+		return false;
 	}
 
-	return cell;
+	return future;
 }
 
-bool Parser::conditional(Cell &cell, Cells &cells, BinaryParseTree &bpt) { //Evaluate a condition.
+bool Parser::conditional(bool alive, int aliveNeighbors, BinaryParseTree &bpt) {
 	std::shared_ptr<BinaryParseTree> keywordOrLiteralNode = bpt.getLeftChild();
 	std::shared_ptr<BinaryParseTree> keywordOrOperandOfKeyworOrLiteralNode = keywordOrLiteralNode->getLeftChild();
 
@@ -46,43 +61,64 @@ bool Parser::conditional(Cell &cell, Cells &cells, BinaryParseTree &bpt) { //Eva
 			if (keywordOrLiteralNode->token.name == Token::lessthanKeyword) {
 				if (keywordOrOperandOfKeyworOrLiteralNode->token.name == Token::orequaltoKeyword) {
 					std::shared_ptr<BinaryParseTree> operand = keywordOrOperandOfKeyworOrLiteralNode->getLeftChild();
-					return aliveNeighborCount(cell, cells) <= operand->token.optionalValue;
+					return aliveNeighbors <= operand->token.optionalValue;
 				}
 				else
-					return aliveNeighborCount(cell, cells) < keywordOrOperandOfKeyworOrLiteralNode->token.optionalValue;
+					return aliveNeighbors < keywordOrOperandOfKeyworOrLiteralNode->token.optionalValue;
 			}
 
 			else if (keywordOrLiteralNode->token.name == Token::greaterthanKeyword) {
 				if (keywordOrOperandOfKeyworOrLiteralNode->token.name == Token::orequaltoKeyword) {
 					std::shared_ptr<BinaryParseTree> operand = keywordOrOperandOfKeyworOrLiteralNode->getLeftChild();
-					return aliveNeighborCount(cell, cells) >= operand->token.optionalValue;
+					return aliveNeighbors >= operand->token.optionalValue;
 				}
 				else
-					return aliveNeighborCount(cell, cells) > keywordOrOperandOfKeyworOrLiteralNode->token.optionalValue;
+					return aliveNeighbors > keywordOrOperandOfKeyworOrLiteralNode->token.optionalValue;
 			}
 		}
 		else {
-			return aliveNeighborCount(cell, cells) == keywordOrLiteralNode->token.optionalValue;
+			return aliveNeighbors == keywordOrLiteralNode->token.optionalValue;
 		}
 	}
 	else { //->
 		if (keywordOrLiteralNode->token.name == Token::aliveKeyword) {
 			if (keywordOrOperandOfKeyworOrLiteralNode->token.name == Token::cellIdentifier)
-				return cell.getAlive();
+				return alive;
 		}
 		else if (keywordOrLiteralNode->token.name == Token::deadKeyword) {
 			if (keywordOrOperandOfKeyworOrLiteralNode->token.name == Token::cellIdentifier)
-				return !cell.getAlive();
+				return !alive;
 		}
 	}
 
 	throw(std::runtime_error("Node not processed!")); //Should never be evaluated.
 }
 
+bool Parser::getFuture(bool alive, int aliveNeighbors) {
+	bool future = alive;
+	for (auto &tree : parseTrees) {
+		future = evaluateFuture(alive, aliveNeighbors, future, *tree);
+	}
+	return future;
+}
+
+void Parser::createTransitionTable() { //Evaluate every expression for each possible (state, alive neighbors) pair.
+	for (int alive = 0; alive < 2; ++alive) {
+		for (int aliveNeighbors = 0; aliveNeighbors <= 8; ++aliveNeighbors) {
+			bool future = alive != 0;
+			for (auto &tree : parseTrees) {
+				future = evaluateFuture(alive != 0, aliveNeighbors, future, *tree);
+			}
+			transitionTable[alive * 9 + aliveNeighbors] = future;
+		}
+	}
+}
+
 void Parser::operator()(std::string str) {
 	Tokenizer tokenizer;
 	std::vector<Token> tokens = tokenizer(str);
 	createParseTree(tokens);
+	createTransitionTable();
 }
 
 void Parser::createParseTree(std::vector<Token> tokens) { //Creates parse tree and assigns its roots to data member parseTrees.
@@ -107,6 +143,8 @@ void Parser::createParseTree(std::vector<Token> tokens) { //Creates parse tree a
 		//Newline indicates the end of an expression.
 		//And perform syntax checking...
 		if (token.name == Token::endofexpressionKeyword) {
+			if (!lastNode) //An empty line, or one without any keyword.
+				continue;
 			if (lastNode->token.name == Token::ifnisKeyword || lastNode->token.name == Token::arrowKeyword || lastNode->token.name == Token::cellIdentifier)
 				throw(std::logic_error("Syntax Error: A rule cannot end with either the keyword IF N IS, ->, or identifiers."));
 
@@ -107,14 +107,27 @@ private:
 
 class Parser {
 public:
+	typedef std::array<bool, 18> transitionTableType; //The future of a cell, indexed by alive * 9 + (amount of alive neighbors).
+
 	void operator()(std::string str);
 	void createParseTree(std::vector<Token> tokens);
 	Cell &operator()(Cell &cell, Cells &cells);
 	Cell &evaluateRulesAndSetFuture(Cell &cell, Cells &cells, BinaryParseTree &bpt);
 	bool conditional(Cell &cell, Cells &cells, BinaryParseTree &bpt);
 
+	bool getFuture(bool alive, int aliveNeighbors); //Evaluate every expression for a single cell, walking the parse trees instead of looking the result up in the transition table. A cell keeps its state unless a rule changes it.
+
+	const transitionTableType &getTransitionTable() const noexcept { //The rules only depend on the state of a cell and its amount of alive neighbors, so they can be evaluated up front for dense worlds.
+		return transitionTable;
+	}
+
 private:
+	bool evaluateFuture(bool alive, int aliveNeighbors, bool future, BinaryParseTree &bpt);
+	bool conditional(bool alive, int aliveNeighbors, BinaryParseTree &bpt);
+	void createTransitionTable();
+
 	std::vector<std::shared_ptr<BinaryParseTree>> parseTrees; //The roots of the trees representing expressions.
+	transitionTableType transitionTable{};
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,143 @@
+#ifndef POOLALLOCATOR_H
+#define POOLALLOCATOR_H
+
+#include "MemoryAccounting.h"
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+
+class PoolBase { //Gives access to every pool of a thread, whatever its block size.
+public:
+	static void sortAllFreeLists() { //Of this thread's pools. Blocks are then handed out in address order, so objects allocated one after another sit next to each other in memory.
+		for (PoolBase *pool : getThreadPools())
+			pool->sortFreeList();
+	}
+
+protected:
+	PoolBase() {
+		getThreadPools().push_back(this);
+	}
+	PoolBase(const PoolBase&) = delete;
+	PoolBase &operator=(const PoolBase&) = delete;
+
+	virtual ~PoolBase() {
+		auto &pools = getThreadPools();
+		pools.erase(std::find(pools.begin(), pools.end(), this));
+	}
+
+	virtual void sortFreeList() = 0;
+
+private:
+	static std::vector<PoolBase*> &getThreadPools() {
+		thread_local std::vector<PoolBase*> pools; //Constructed by the first pool, so destroyed after the last one.
+		return pools;
+	}
+};
+
+template<std::size_t blockSize, std::size_t blockAlignment, MemoryAccounting::Tag tag>
+class FixedSizePool : public PoolBase { //Hands out equally sized blocks carved from large chunks, and keeps freed blocks in a free list for reuse. One per thread, so no locks are needed.
+public:
+	static constexpr std::size_t blocksPerChunk = 1024;
+
+	static FixedSizePool &get() {
+		thread_local FixedSizePool pool;
+		return pool;
+	}
+
+	~FixedSizePool() {
+		if (liveBlocks) //Something allocated on this thread outlives it. Leak the chunks rather than free memory that is still in use.
+			return;
+		for (Block *chunk : chunks) {
+			TaggedAllocator<Block, tag>().deallocate(chunk, blocksPerChunk);
+		}
+	}
+
+	void *allocate() {
+		if (!freeList)
+			addChunk();
+
+		Block *block = freeList;
+		freeList = block->next;
+		++liveBlocks;
+		return block;
+	}
+
+	void deallocate(void *ptr) noexcept { //Must be called on the thread that allocated ptr.
+		Block *block = static_cast<Block*>(ptr);
+		block->next = freeList;
+		freeList = block;
+		--liveBlocks;
+	}
+
+private:
+	union Block {
+		Block *next; //While the block is free.
+		alignas(blockAlignment) unsigned char storage[blockSize];
+	};
+
+	FixedSizePool() = default;
+
+	void sortFreeList() override {
+		sortingBuffer.clear();
+		for (Block *block = freeList; block; block = block->next)
+			sortingBuffer.push_back(block);
+		std::sort(sortingBuffer.begin(), sortingBuffer.end(), std::greater<Block*>());
+
+		freeList = nullptr;
+		for (Block *block : sortingBuffer) { //Pushing the highest address first leaves the lowest at the front.
+			block->next = freeList;
+			freeList = block;
+		}
+	}
+
+	void addChunk() {
+		Block *chunk = TaggedAllocator<Block, tag>().allocate(blocksPerChunk);
+		chunks.push_back(chunk);
+		for (std::size_t i = 0; i < blocksPerChunk; ++i) {
+			chunk[i].next = freeList;
+			freeList = &chunk[i];
+		}
+	}
+
+	std::vector<Block*> chunks;
+	std::vector<Block*> sortingBuffer; //Reused by sortFreeList.
+	Block *freeList{ nullptr };
+	std::size_t liveBlocks{ 0 };
+};
+
+template<typename T, MemoryAccounting::Tag tag>
+class PoolAllocator { //For node based containers. Single nodes come from a FixedSizePool, arrays (such as the buckets of a hash map) from TaggedAllocator.
+public:
+	typedef T value_type;
+
+	template<typename U> struct rebind {
+		typedef PoolAllocator<U, tag> other;
+	};
+
+	PoolAllocator() noexcept = default;
+	template<typename U> PoolAllocator(const PoolAllocator<U, tag>&) noexcept {}
+
+	T *allocate(std::size_t n) {
+		if (n == 1)
+			return static_cast<T*>(FixedSizePool<sizeof(T), alignof(T), tag>::get().allocate());
+		return TaggedAllocator<T, tag>().allocate(n);
+	}
+
+	void deallocate(T *ptr, std::size_t n) noexcept {
+		if (n == 1)
+			FixedSizePool<sizeof(T), alignof(T), tag>::get().deallocate(ptr);
+		else
+			TaggedAllocator<T, tag>().deallocate(ptr, n);
+	}
+
+	friend bool operator==(const PoolAllocator&, const PoolAllocator&) noexcept {
+		return true;
+	}
+	friend bool operator!=(const PoolAllocator&, const PoolAllocator&) noexcept {
+		return false;
+	}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "PopulationIndex.h"
+
+#include <algorithm>
+#include <bitset>
+#include <utility>
+
+namespace {
+	Position parentOf(Position node) { //Shifting a signed coordinate right rounds towards negative infinity, as with the chunks.
+		return Position{ node.x >> 1, node.y >> 1 };
+	}
+}
+
+void PopulationIndex::update(Position pos, bool alive) {
+	Position chunkPos{ pos.x >> chunkShift, pos.y >> chunkShift };
+	Chunk &chunk = chunks[chunkPos];
+
+	std::uint16_t bit = std::uint16_t(1u << (pos.x & (chunkSize - 1)));
+	std::uint16_t &row = chunk.rows[pos.y & (chunkSize - 1)];
+	if (alive) {
+		row |= bit;
+		++chunk.population;
+	}
+	else {
+		row &= ~bit;
+		--chunk.population;
+	}
+
+	if (!chunk.dirty) {
+		chunk.dirty = true;
+		dirtyChunks.push_back(chunkPos);
+	}
+}
+
+void PopulationIndex::clear() {
+	chunks.clear();
+	for (auto &level : levels)
+		level.clear();
+	dirtyChunks.clear();
+}
+
+PopulationIndex::countType PopulationIndex::count(Position min, Position max) {
+	if (min.x > max.x || min.y > max.y)
+		return 0;
+
+	propagate();
+	return countAll(min, max, false);
+}
+
+bool PopulationIndex::anyAlive(Position min, Position max) {
+	if (min.x > max.x || min.y > max.y)
+		return false;
+
+	propagate();
+	return countAll(min, max, true) != 0;
+}
+
+void PopulationIndex::propagate() {
+	if (dirtyChunks.empty())
+		return;
+
+	deltas.clear();
+	for (Position chunkPos : dirtyChunks) {
+		auto it = chunks.find(chunkPos);
+		Chunk &chunk = it->second;
+		long long delta = static_cast<long long>(chunk.population) - static_cast<long long>(chunk.propagated);
+		chunk.propagated = chunk.population;
+		chunk.dirty = false;
+		if (delta)
+			deltas[parentOf(chunkPos)] += delta;
+		if (!chunk.population)
+			chunks.erase(it);
+	}
+	dirtyChunks.clear();
+
+	for (auto &level : levels) {
+		parentDeltas.clear();
+		for (auto &delta : deltas) {
+			if (!delta.second) //The births and deaths below this node cancelled out.
+				continue;
+
+			auto it = level.emplace(delta.first, 0).first;
+			it->second = countType(static_cast<long long>(it->second) + delta.second);
+			if (!it->second)
+				level.erase(it);
+			parentDeltas[parentOf(delta.first)] += delta.second;
+		}
+		std::swap(deltas, parentDeltas);
+	}
+}
+
+PopulationIndex::countType PopulationIndex::countAll(Position min, Position max, bool stopAtFirst) const {
+	constexpr int topShift = chunkShift + levelCount;
+
+	countType total = 0;
+	for (Position::coordType y = min.y >> topShift; y <= max.y >> topShift; ++y) {
+		for (Position::coordType x = min.x >> topShift; x <= max.x >> topShift; ++x) {
+			total += countIn(levelCount, Position{ x, y }, min, max, stopAtFirst);
+			if (stopAtFirst && total)
+				return total;
+		}
+	}
+	return total;
+}
+
+PopulationIndex::countType PopulationIndex::countIn(int level, Position node, Position min, Position max, bool stopAtFirst) const {
+	//The cells the node covers. Computed unsigned, as the last cell of the top level nodes is at the edge of what Position::coordType can hold.
+	int shift = chunkShift + level;
+	unsignedCoordType lastOffset = (unsignedCoordType(1) << shift) - 1;
+	Position nodeMin{ Position::coordType(unsignedCoordType(node.x) << shift), Position::coordType(unsignedCoordType(node.y) << shift) };
+	Position nodeMax{ Position::coordType(unsignedCoordType(nodeMin.x) + lastOffset), Position::coordType(unsignedCoordType(nodeMin.y) + lastOffset) };
+
+	if (nodeMax.x < min.x || nodeMin.x > max.x || nodeMax.y < min.y || nodeMin.y > max.y)
+		return 0;
+
+	bool covered = min.x <= nodeMin.x && nodeMax.x <= max.x && min.y <= nodeMin.y && nodeMax.y <= max.y;
+
+	if (!level) {
+		auto it = chunks.find(node);
+		if (it == chunks.end())
+			return 0;
+		if (covered)
+			return it->second.population;
+
+		//Count the bits inside the rectangle, row by row.
+		int firstX = int(std::max(min.x, nodeMin.x) - nodeMin.x), lastX = int(std::min(max.x, nodeMax.x) - nodeMin.x);
+		int firstY = int(std::max(min.y, nodeMin.y) - nodeMin.y), lastY = int(std::min(max.y, nodeMax.y) - nodeMin.y);
+		std::uint16_t mask = std::uint16_t(((1u << (lastX - firstX + 1)) - 1) << firstX);
+		countType total = 0;
+		for (int y = firstY; y <= lastY; ++y)
+			total += std::bitset<chunkSize>(it->second.rows[y] & mask).count();
+		return total;
+	}
+
+	const nodeContainerType &nodes = levels[level - 1];
+	auto it = nodes.find(node);
+	if (it == nodes.end())
+		return 0;
+	if (covered)
+		return it->second;
+
+	countType total = 0;
+	for (unsignedCoordType dy = 0; dy < 2; ++dy) {
+		for (unsignedCoordType dx = 0; dx < 2; ++dx) {
+			Position child{ Position::coordType((unsignedCoordType(node.x) << 1) + dx), Position::coordType((unsignedCoordType(node.y) << 1) + dy) };
+			total += countIn(level - 1, child, min, max, stopAtFirst);
+			if (stopAtFirst && total)
+				return total;
+		}
+	}
+	return total;
+}
@@ -0,0 +1,56 @@
+#ifndef POPULATIONINDEX_H
+#define POPULATIONINDEX_H
+
+#include "Position.h"
+#include "ChangeListener.h"
+#include "MemoryAccounting.h"
+
+#include <unordered_map>
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+class PopulationIndex : public ChangeListener { //Counts the alive cells in a rectangle without visiting them. Cells are stored as one bit each in chunks of 16x16 cells, and the populations of the chunks are summed up a quadtree whose levels each cover twice the width of the one below, up to four nodes that cover the whole plane. Add it to Cells with addChangeListener.
+public:
+	typedef std::size_t countType;
+
+	void update(Position pos, bool alive) override; //Only marks the chunk; the levels above it are brought up to date by the next query.
+	void clear() override;
+
+	countType count(Position min, Position max); //Alive cells with min.x <= x <= max.x and min.y <= y <= max.y. In a world that wraps around, the rectangle does not.
+	bool anyAlive(Position min, Position max); //Like count, but stops at the first alive cell.
+
+	static constexpr int chunkShift = 4;
+	static constexpr Position::coordType chunkSize = 1 << chunkShift;
+
+private:
+	typedef std::make_unsigned_t<Position::coordType> unsignedCoordType;
+
+	static constexpr int levelCount = int(sizeof(Position::coordType)) * 8 - 1 - chunkShift; //Above the chunks. The nodes of the top level are 2^31 (or 2^63) cells wide, so there are at most four of them.
+
+	class Chunk {
+	public:
+		std::array<std::uint16_t, chunkSize> rows{}; //Bit x of row y is the cell at (x, y) relative to the top left corner of the chunk.
+		countType population{ 0 };
+		countType propagated{ 0 }; //The population the levels above know of.
+		bool dirty = false; //In dirtyChunks.
+	};
+
+	typedef std::unordered_map<Position, Chunk, PositionHasher, std::equal_to<Position>, TaggedAllocator<std::pair<const Position, Chunk>, MemoryAccounting::populationIndex>> chunkContainerType;
+	typedef std::unordered_map<Position, countType, PositionHasher, std::equal_to<Position>, TaggedAllocator<std::pair<const Position, countType>, MemoryAccounting::populationIndex>> nodeContainerType;
+	typedef std::unordered_map<Position, long long, PositionHasher, std::equal_to<Position>, TaggedAllocator<std::pair<const Position, long long>, MemoryAccounting::populationIndex>> deltaContainerType;
+
+	void propagate(); //Add the population changes of the dirty chunks to every level, one level at a time, so changes below the same node are added to it once.
+	countType countAll(Position min, Position max, bool stopAtFirst) const;
+	countType countIn(int level, Position node, Position min, Position max, bool stopAtFirst) const; //Level 0 are the chunks.
+
+	chunkContainerType chunks; //Keyed by position >> chunkShift. Chunks without alive cells are removed.
+	std::array<nodeContainerType, levelCount> levels; //levels[i] holds the populations of the nodes of level i + 1, keyed by position >> (chunkShift + i + 1). Nodes without alive cells are removed.
+	std::vector<Position> dirtyChunks; //Changed since the last propagate.
+	deltaContainerType deltas, parentDeltas; //Used in propagate.
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+template<typename T>
+class BasicPosition {
+public:
+	typedef T coordType; //Signed integer.
+
+	BasicPosition(coordType x, coordType y) : x{ x }, y{ y } {}
+	BasicPosition() = default;
+
+	friend bool operator==(const BasicPosition &pos1, const BasicPosition &pos2) {
+		return pos1.x == pos2.x && pos1.y == pos2.y;
+	}
+	friend bool operator!=(const BasicPosition &pos1, const BasicPosition &pos2) {
+		return !(pos1 == pos2);
+	}
+	friend BasicPosition operator+(const BasicPosition &pos1, const BasicPosition &pos2) {
+		return BasicPosition{ pos1.x + pos2.x, pos1.y + pos2.y };
+	}
+	friend BasicPosition operator-(const BasicPosition &pos1, const BasicPosition &pos2) {
+		return BasicPosition{ pos1.x - pos2.x, pos1.y - pos2.y };
+	}
+
+	coordType x = { 0 }, y = { 0 };
+};
+
+//32 bit coordinates by default. Define GOL_64BIT_COORDINATES for worlds that grow beyond 2^31 cells from the origin, such as the output of a glider gun after about 2^33 generations. Cells then take almost twice the memory, as each one stores the positions of its neighbors.
+#ifdef GOL_64BIT_COORDINATES
+typedef BasicPosition<std::int64_t> Position;
+#else
+typedef BasicPosition<std::int32_t> Position;
+#endif
+
+class PositionHasher {
+public:
+	std::size_t operator()(const Position &pos) const { //Both coordinates in one 64 bit key, mixed by the finalizer of MurmurHash3, so every bit of x and y affects every bit of the hash. (Combining std::hash of both gave nearby positions only about 2^17 different hashes, and long chains in the buckets.)
+		std::uint64_t key;
+		if constexpr (sizeof(Position::coordType) > 4) { //The upper half of x ends up in the lower half of the key, so no bit is lost.
+			std::uint64_t x = static_cast<std::uint64_t>(pos.x);
+			key = ((x << 32) | (x >> 32)) ^ static_cast<std::uint64_t>(pos.y);
+		}
+		else
+			key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(pos.x)) << 32) | static_cast<std::uint32_t>(pos.y);
+		key ^= key >> 33;
+		key *= 0xff51afd7ed558ccdull;
+		key ^= key >> 33;
+		key *= 0xc4ceb9fe1a85ec53ull;
+		key ^= key >> 33;
+		return static_cast<std::size_t>(key);
+	}
+};
+
+class MortonHasher { //Interleaves the bits of x and y (Z-order), so positions that are close together get close hash values, and sorting by it keeps them close together.
+public:
+	std::size_t operator()(const Position &pos) const {
+		return static_cast<std::size_t>(getKey(pos));
+	}
+
+	static std::uint64_t getKey(const Position &pos) { //Of the lower 32 bits of each coordinate, so with 64 bit coordinates the order is only spatial within a 2^32 x 2^32 area. That is enough for locality in memory.
+		//Flip the sign bits, so negative coordinates come before positive ones.
+		return spreadBits(static_cast<std::uint32_t>(pos.x) ^ 0x80000000u) | (spreadBits(static_cast<std::uint32_t>(pos.y) ^ 0x80000000u) << 1);
+	}
+
+private:
+	static std::uint64_t spreadBits(std::uint32_t value) { //Moves bit i to bit 2i.
+		std::uint64_t result = value;
+		result = (result | (result << 16)) & 0x0000FFFF0000FFFFull;
+		result = (result | (result << 8)) & 0x00FF00FF00FF00FFull;
+		result = (result | (result << 4)) & 0x0F0F0F0F0F0F0F0Full;
+		result = (result | (result << 2)) & 0x3333333333333333ull;
+		result = (result | (result << 1)) & 0x5555555555555555ull;
+		return result;
+	}
+};
+
+class CellsHasher { //PositionHasher or MortonHasher, chosen when the container of cells is created.
+public:
+	CellsHasher(bool zO = false) : zOrder{ zO } {}
+
+	std::size_t operator()(const Position &pos) const {
+		return zOrder ? MortonHasher{}(pos) : PositionHasher{}(pos);
+	}
+
+	bool getZOrder() const noexcept {
+		return zOrder;
+	}
+
+private:
+	bool zOrder;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+Profiler &Profiler::get() {
+	thread_local Profiler profiler;
+	return profiler;
+}
+
+const char *Profiler::getPhaseName(Phase phase) {
+	switch (phase) {
+	case tick: return "tick";
+	case expansion: return "expansion";
+	case ruleEvaluation: return "rules";
+	case applyingFutures: return "apply futures";
+	case recordingChanges: return "record changes";
+	case maintenance: return "maintenance";
+	case relayout: return "relayout";
+	case renderingCells: return "render cells";
+	case renderingGUI: return "render gui";
+	case display: return "display";
+	case handlingEvents: return "events";
+	case autosaving: return "autosave";
+	default: return "unknown";
+	}
+}
+
+void Profiler::addSample(Phase phase, std::chrono::nanoseconds duration) {
+	PhaseSamples &samples = phaseSamples[phase];
+	samples.durations[samples.next] = duration.count();
+	samples.next = (samples.next + 1) % windowSize;
+	samples.count = std::min(samples.count + 1, windowSize);
+
+	if (csvStream.is_open()) {
+		auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime);
+		csvStream << timestamp.count() << ',' << getPhaseName(phase) << ',' << duration.count() << '\n';
+	}
+}
+
+std::chrono::nanoseconds Profiler::getPercentile(Phase phase, double percentile) const {
+	const PhaseSamples &samples = phaseSamples[phase];
+	if (!samples.count)
+		return std::chrono::nanoseconds(0);
+
+	sortingBuffer.assign(samples.durations.begin(), samples.durations.begin() + samples.count);
+
+	auto rank = static_cast<std::size_t>(std::ceil(percentile / 100 * samples.count));
+	auto nth = sortingBuffer.begin() + std::min(std::max<std::size_t>(rank, 1), samples.count) - 1;
+	std::nth_element(sortingBuffer.begin(), nth, sortingBuffer.end());
+
+	return std::chrono::nanoseconds(*nth);
+}
+
+void Profiler::setCSVOutput(const std::string &filePath) {
+	csvStream.open(filePath, std::ios::out | std::ios::trunc);
+	if (!csvStream.is_open())
+		throw(std::logic_error("Error opening profiling output file."));
+
+	csvStream << "timestamp_ns,phase,duration_ns\n";
+}
@@ -0,0 +1,87 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#include "Trace.h"
+
+//Timing of the phases of a tick and of a frame. Define GOL_NO_PROFILING to compile all timers out.
+
+class Profiler { //Keeps the most recent durations of each phase. One per thread, so worlds simulated on other threads do not mix their samples.
+public:
+	enum Phase {
+		tick,
+		expansion,
+		ruleEvaluation,
+		applyingFutures,
+		recordingChanges, //History, statistics and the world hash.
+		maintenance,
+		relayout,
+		renderingCells,
+		renderingGUI,
+		display,
+		handlingEvents,
+		autosaving, //Handing the changed cells to the autosave thread.
+		phaseCount
+	};
+
+	static constexpr std::size_t windowSize = 1024; //Amount of recent samples kept for each phase.
+
+	static Profiler &get();
+	static const char *getPhaseName(Phase phase);
+
+	void addSample(Phase phase, std::chrono::nanoseconds duration);
+	std::chrono::nanoseconds getPercentile(Phase phase, double percentile) const; //Over the most recent samples. 0 if there are none.
+
+	std::size_t getSampleCount(Phase phase) const noexcept {
+		return phaseSamples[phase].count;
+	}
+
+	void setCSVOutput(const std::string &filePath); //Stream every sample to a file, for offline analysis.
+
+private:
+	class PhaseSamples { //Ring buffer.
+	public:
+		std::array<std::int64_t, windowSize> durations{}; //Nanoseconds.
+		std::size_t next{ 0 };
+		std::size_t count{ 0 };
+	};
+
+	std::array<PhaseSamples, phaseCount> phaseSamples;
+	mutable std::vector<std::int64_t> sortingBuffer; //Reused by getPercentile.
+	std::ofstream csvStream;
+	std::chrono::steady_clock::time_point startTime{ std::chrono::steady_clock::now() };
+};
+
+class ScopedTimer { //Adds the time between its construction and destruction to the profiler. Also shows up on the trace timeline, when tracing.
+public:
+	ScopedTimer(Profiler::Phase p) : trace{ Profiler::getPhaseName(p) }, phase{ p }, start{ std::chrono::steady_clock::now() } {}
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer &operator=(const ScopedTimer&) = delete;
+
+	~ScopedTimer() {
+		Profiler::get().addSample(phase, std::chrono::steady_clock::now() - start);
+	}
+
+private:
+	ScopedTrace trace;
+	Profiler::Phase phase;
+	std::chrono::steady_clock::time_point start;
+};
+
+#define PROFILER_CONCATENATE_IMPLEMENTATION(a, b) a##b
+#define PROFILER_CONCATENATE(a, b) PROFILER_CONCATENATE_IMPLEMENTATION(a, b)
+
+#ifndef GOL_NO_PROFILING
+#define PROFILE_SCOPE(phase) ScopedTimer PROFILER_CONCATENATE(scopedTimer, __LINE__)(Profiler::phase)
+#else
+#define PROFILE_SCOPE(phase)
+#endif
+
+#endif
@@ -0,0 +1,26 @@
+#include "RuleKernels.h"
+
+RuleMasks::RuleMasks(const Parser::transitionTableType &transitionTable) : birth{ 0 }, survival{ 0 } {
+	for (int aliveNeighbors = 0; aliveNeighbors <= 8; ++aliveNeighbors) {
+		if (transitionTable[aliveNeighbors])
+			birth |= 1 << aliveNeighbors;
+		if (transitionTable[9 + aliveNeighbors])
+			survival |= 1 << aliveNeighbors;
+	}
+}
+
+std::string RuleMasks::toString() const {
+	std::string str = "B";
+	for (int aliveNeighbors = 0; aliveNeighbors <= 8; ++aliveNeighbors) {
+		if ((birth >> aliveNeighbors) & 1)
+			str += char('0' + aliveNeighbors);
+	}
+
+	str += "/S";
+	for (int aliveNeighbors = 0; aliveNeighbors <= 8; ++aliveNeighbors) {
+		if ((survival >> aliveNeighbors) & 1)
+			str += char('0' + aliveNeighbors);
+	}
+
+	return str;
+}
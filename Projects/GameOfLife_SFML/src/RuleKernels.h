@@ -0,0 +1,75 @@
+#ifndef RULEKERNELS_H
+#define RULEKERNELS_H
+
+#include "Parser.h"
+
+#include <cstdint>
+#include <string>
+
+//The rules of a tick reduced to two masks: bit n of the birth mask is set if a dead cell with n alive neighbors comes to life, bit n of the survival mask if an alive one stays alive.
+//Common rules get a kernel with the masks as template parameters, so the test compiles to a bit test of a constant instead of a load from a table. Other rules use the transition table.
+
+class RuleMasks {
+public:
+	typedef std::uint16_t maskType;
+
+	RuleMasks(maskType b, maskType s) : birth{ b }, survival{ s } {}
+	explicit RuleMasks(const Parser::transitionTableType &transitionTable);
+
+	friend bool operator==(const RuleMasks &masks1, const RuleMasks &masks2) {
+		return masks1.birth == masks2.birth && masks1.survival == masks2.survival;
+	}
+
+	std::string toString() const; //In B/S notation, such as "B3/S23".
+
+	maskType birth;
+	maskType survival;
+};
+
+template<RuleMasks::maskType birthMask, RuleMasks::maskType survivalMask>
+class RuleKernel {
+public:
+	static constexpr RuleMasks::maskType birth = birthMask, survival = survivalMask;
+
+	bool operator()(bool alive, int aliveNeighbors) const noexcept {
+		return ((alive ? survivalMask : birthMask) >> aliveNeighbors) & 1;
+	}
+};
+
+typedef RuleKernel<(1 << 3), (1 << 2) | (1 << 3)> LifeKernel; //B3/S23
+typedef RuleKernel<(1 << 3) | (1 << 6), (1 << 2) | (1 << 3)> HighLifeKernel; //B36/S23
+typedef RuleKernel<(1 << 3) | (1 << 6) | (1 << 7) | (1 << 8), (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8)> DayAndNightKernel; //B3678/S34678
+typedef RuleKernel<(1 << 2), 0> SeedsKernel; //B2/S
+
+class TableRuleKernel { //Any other rules.
+public:
+	explicit TableRuleKernel(const Parser::transitionTableType &tt) : transitionTable{ tt } {}
+
+	bool operator()(bool alive, int aliveNeighbors) const noexcept {
+		return transitionTable[alive * 9 + aliveNeighbors];
+	}
+
+private:
+	const Parser::transitionTableType &transitionTable;
+};
+
+template<typename Kernel> bool matches(const RuleMasks &masks) {
+	return masks == RuleMasks(Kernel::birth, Kernel::survival);
+}
+
+template<typename F> void withRuleKernel(const Parser::transitionTableType &transitionTable, F f) { //Calls f with the kernel for the rules, so the loop in f is compiled once for each kernel.
+	const RuleMasks masks(transitionTable);
+
+	if (matches<LifeKernel>(masks))
+		f(LifeKernel());
+	else if (matches<HighLifeKernel>(masks))
+		f(HighLifeKernel());
+	else if (matches<DayAndNightKernel>(masks))
+		f(DayAndNightKernel());
+	else if (matches<SeedsKernel>(masks))
+		f(SeedsKernel());
+	else
+		f(TableRuleKernel(transitionTable));
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "ShardedSimulation.h"
+#include "Cell.h"
+#include "FileProcessing.h"
+#include "Options.h"
+#include "MemoryAccounting.h"
+
+#include <iostream>
+
+#ifdef __linux__
+#include <chrono>
+#include <vector>
+#include <string>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <iomanip>
+#include <cerrno>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//Each shard is a process owning the rows [firstRow, endRow) of the plane. The first and the last shard reach out to infinity.
+//Before each generation, neighboring shards send each other the alive cells of their outermost rows (the halo). Each places the cells it received just outside its own rows, steps, and then removes every cell outside its own rows again, as those were not computed from complete neighborhoods.
+
+namespace {
+	typedef std::vector<Position::coordType> rowType; //The x coordinates of the alive cells in a row.
+
+	class Shard {
+	public:
+		unsigned index;
+		Position::coordType firstRow, endRow;
+		int upSocket{ -1 }, downSocket{ -1 }; //To the shards owning the rows above and below. -1 if there is none.
+		int coordinatorSocket{ -1 };
+
+		bool owns(Position pos) const noexcept {
+			return pos.y >= firstRow && pos.y < endRow;
+		}
+	};
+
+	class ShardSummary { //Sent to the coordinator after the last generation.
+	public:
+		std::uint64_t population;
+		Position boundingBoxMin, boundingBoxMax;
+		WorldHash worldHash;
+		std::uint64_t memoryBytes;
+	};
+
+	void sendAll(int socket, const void *data, std::size_t size) {
+		const char *bytes = static_cast<const char*>(data);
+		while (size) {
+			ssize_t sent = send(socket, bytes, size, MSG_NOSIGNAL);
+			if (sent < 0) {
+				if (errno == EINTR)
+					continue;
+				throw(std::logic_error("Sending to another shard failed."));
+			}
+			bytes += sent;
+			size -= std::size_t(sent);
+		}
+	}
+
+	void receiveAll(int socket, void *data, std::size_t size) {
+		char *bytes = static_cast<char*>(data);
+		while (size) {
+			ssize_t received = recv(socket, bytes, size, 0);
+			if (received < 0) {
+				if (errno == EINTR)
+					continue;
+				throw(std::logic_error("Receiving from another shard failed."));
+			}
+			if (!received)
+				throw(std::logic_error("Another shard stopped."));
+			bytes += received;
+			size -= std::size_t(received);
+		}
+	}
+
+	void sendRow(int socket, const rowType &row) {
+		std::uint64_t count = row.size();
+		sendAll(socket, &count, sizeof(count));
+		sendAll(socket, row.data(), row.size() * sizeof(rowType::value_type));
+	}
+
+	void receiveRow(int socket, rowType &row) {
+		std::uint64_t count;
+		receiveAll(socket, &count, sizeof(count));
+		row.resize(count);
+		receiveAll(socket, row.data(), row.size() * sizeof(rowType::value_type));
+	}
+
+	void exchangeHalo(const Shard &shard, const rowType &topRow, const rowType &bottomRow, rowType &haloAbove, rowType &haloBelow) {
+		//Every send is paired with a receive on the other end, so shards never wait for each other in a circle however large the rows are.
+		//Even shards send while odd ones receive, then the other way around. First downwards, then upwards.
+		bool even = shard.index % 2 == 0;
+		for (int phase = 0; phase < 2; ++phase) {
+			if ((phase == 0) == even) {
+				if (shard.downSocket >= 0)
+					sendRow(shard.downSocket, bottomRow);
+			}
+			else if (shard.upSocket >= 0)
+				receiveRow(shard.upSocket, haloAbove);
+		}
+		for (int phase = 0; phase < 2; ++phase) {
+			if ((phase == 0) == even) {
+				if (shard.upSocket >= 0)
+					sendRow(shard.upSocket, topRow);
+			}
+			else if (shard.downSocket >= 0)
+				receiveRow(shard.downSocket, haloBelow);
+		}
+	}
+
+	void runShard(const Shard &shard, const std::string &rulesStr, const std::string &mapStr, Cells::generationType generations) {
+		Cells cells;
+		cells.setRules(rulesStr);
+		cells.setRecordHistory(false);
+
+		Cells::changeContainerType edits;
+		for (auto &edit : getPatternFromStr(mapStr)) {
+			if (edit.second && shard.owns(edit.first))
+				edits.push_back(edit);
+		}
+		cells.applyEdits(edits);
+
+		rowType topRow, bottomRow, haloAbove, haloBelow;
+		auto collectRows = [&] { //Also queues the removal of cells outside the rows of this shard.
+			edits.clear();
+			topRow.clear();
+			bottomRow.clear();
+			cells.forEachAliveCell([&](Position pos) {
+				if (!shard.owns(pos))
+					edits.emplace_back(pos, false);
+				else {
+					if (pos.y == shard.firstRow && shard.upSocket >= 0)
+						topRow.push_back(pos.x);
+					if (pos.y == shard.endRow - 1 && shard.downSocket >= 0)
+						bottomRow.push_back(pos.x);
+				}
+			});
+		};
+		collectRows();
+
+		for (Cells::generationType generation = 1; generation <= generations; ++generation) {
+			exchangeHalo(shard, topRow, bottomRow, haloAbove, haloBelow);
+
+			edits.clear();
+			if (shard.upSocket >= 0) {
+				for (Position::coordType x : haloAbove)
+					edits.emplace_back(Position{ x, shard.firstRow - 1 }, true);
+			}
+			if (shard.downSocket >= 0) {
+				for (Position::coordType x : haloBelow)
+					edits.emplace_back(Position{ x, shard.endRow }, true);
+			}
+			if (!edits.empty())
+				cells.applyEdits(edits);
+
+			cells.updateCells();
+
+			collectRows();
+			if (!edits.empty())
+				cells.applyEdits(edits);
+
+			if (generation % Cells::maintenanceInterval == 0)
+				cells.performMaintenance();
+
+			std::uint64_t population = cells.getStatistics().getPopulation();
+			sendAll(shard.coordinatorSocket, &population, sizeof(population));
+		}
+
+		ShardSummary summary;
+		summary.population = cells.getStatistics().getPopulation();
+		summary.boundingBoxMin = cells.getStatistics().getBoundingBoxMin();
+		summary.boundingBoxMax = cells.getStatistics().getBoundingBoxMax();
+		cells.forEachAliveCell([&summary](Position pos) {
+			summary.worldHash.update(pos, true);
+		});
+		summary.memoryBytes = MemoryAccounting::getTotalBytes();
+		sendAll(shard.coordinatorSocket, &summary, sizeof(summary));
+	}
+}
+
+int runSharded(const Options &options) {
+	std::string rulesStr = readFile(options.rulesFilePath), mapStr = readFile(options.mapFilePath);
+	Position::coordType mapHeight = getMapSize(mapStr).y;
+	if (Position::coordType(options.shards) > mapHeight)
+		throw(std::invalid_argument("Every shard needs at least one row of the map."));
+
+	std::vector<Shard> shards(options.shards);
+	for (unsigned index = 0; index < options.shards; ++index) { //Equally high stripes of the map.
+		shards[index].index = index;
+		shards[index].firstRow = index ? Position::coordType(std::int64_t(mapHeight) * index / options.shards) : std::numeric_limits<Position::coordType>::min();
+		shards[index].endRow = index + 1 < options.shards ? Position::coordType(std::int64_t(mapHeight) * (index + 1) / options.shards) : std::numeric_limits<Position::coordType>::max();
+	}
+
+	std::vector<int> coordinatorSockets(shards.size()), allSockets;
+	for (std::size_t index = 0; index < shards.size(); ++index) {
+		int sockets[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+			throw(std::logic_error("Creating a socket between processes failed."));
+		coordinatorSockets[index] = sockets[0];
+		shards[index].coordinatorSocket = sockets[1];
+		allSockets.insert(allSockets.end(), sockets, sockets + 2);
+
+		if (index + 1 < shards.size()) {
+			if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+				throw(std::logic_error("Creating a socket between processes failed."));
+			shards[index].downSocket = sockets[0];
+			shards[index + 1].upSocket = sockets[1];
+			allSockets.insert(allSockets.end(), sockets, sockets + 2);
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::cout.flush(); //Otherwise the workers would print what is still buffered as well.
+	std::vector<pid_t> workers;
+	for (const Shard &shard : shards) {
+		pid_t pid = fork();
+		if (pid < 0)
+			throw(std::logic_error("Starting a shard process failed."));
+
+		if (!pid) {
+			for (int socket : allSockets) { //So a shard that stops is noticed by the others.
+				if (socket != shard.upSocket && socket != shard.downSocket && socket != shard.coordinatorSocket)
+					close(socket);
+			}
+
+			int exitCode = 0;
+			try {
+				runShard(shard, rulesStr, mapStr, options.generations);
+			}
+			catch (std::exception &e) {
+				std::cerr << "Shard " << shard.index << ": " << e.what() << "\n";
+				exitCode = 1;
+			}
+			_exit(exitCode);
+		}
+		workers.push_back(pid);
+	}
+	for (int socket : allSockets) {
+		if (std::find(coordinatorSockets.begin(), coordinatorSockets.end(), socket) == coordinatorSockets.end())
+			close(socket);
+	}
+
+	int result = 0;
+	std::vector<ShardSummary> summaries(shards.size());
+	std::uint64_t peakPopulation = 0;
+	try {
+		for (Cells::generationType generation = 1; generation <= options.generations; ++generation) {
+			std::uint64_t population = 0;
+			for (int socket : coordinatorSockets) {
+				std::uint64_t shardPopulation;
+				receiveAll(socket, &shardPopulation, sizeof(shardPopulation));
+				population += shardPopulation;
+			}
+			peakPopulation = std::max(peakPopulation, population);
+		}
+		for (std::size_t index = 0; index < shards.size(); ++index)
+			receiveAll(coordinatorSockets[index], &summaries[index], sizeof(ShardSummary));
+	}
+	catch (std::exception &e) {
+		std::cerr << e.what() << "\n";
+		result = 1;
+	}
+
+	for (int socket : coordinatorSockets)
+		close(socket);
+	for (pid_t pid : workers) {
+		int status;
+		if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status))
+			result = 1;
+	}
+	if (result)
+		return result;
+
+	auto timeTaken = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+	std::uint64_t population = 0;
+	Position boundingBoxMin, boundingBoxMax;
+	WorldHash worldHash;
+	for (const ShardSummary &summary : summaries) {
+		if (summary.population) {
+			if (!population) {
+				boundingBoxMin = summary.boundingBoxMin;
+				boundingBoxMax = summary.boundingBoxMax;
+			}
+			boundingBoxMin = Position{ std::min(boundingBoxMin.x, summary.boundingBoxMin.x), std::min(boundingBoxMin.y, summary.boundingBoxMin.y) };
+			boundingBoxMax = Position{ std::max(boundingBoxMax.x, summary.boundingBoxMax.x), std::max(boundingBoxMax.y, summary.boundingBoxMax.y) };
+		}
+		population += summary.population;
+		worldHash.add(summary.worldHash);
+	}
+
+	std::cout << "Generation: " << options.generations << "\n";
+	std::cout << "Alive cells: " << population << "\n";
+	std::cout << "Bounding box: (" << boundingBoxMin.x << ", " << boundingBoxMin.y << ") to (" << boundingBoxMax.x << ", " << boundingBoxMax.y << ")\n";
+	std::cout << "World hash: " << std::hex << std::setw(16) << std::setfill('0') << worldHash.getHash() << std::dec << std::setfill(' ') << "\n";
+	std::cout << "Peak population: " << peakPopulation << "\n";
+	std::cout << "Time: " << timeTaken.count() << " ms\n";
+
+	std::cout << "Memory per shard:\n";
+	for (std::size_t index = 0; index < shards.size(); ++index) {
+		std::cout << "  rows " << (index ? std::to_string(shards[index].firstRow) : "-inf") << " to " << (index + 1 < shards.size() ? std::to_string(shards[index].endRow - 1) : "+inf")
+			<< ": " << summaries[index].population << " cells, " << summaries[index].memoryBytes / 1024 << " KB\n";
+	}
+
+	return 0;
+}
+#else
+int runSharded(const Options &options) {
+	std::cerr << "--shards is only available on Linux.\n";
+	return 1;
+}
+#endif
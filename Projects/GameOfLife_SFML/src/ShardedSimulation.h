@@ -0,0 +1,8 @@
+#ifndef SHARDEDSIMULATION_H
+#define SHARDEDSIMULATION_H
+
+#include "Options.h"
+
+int runSharded(const Options &options); //Simulate options.generations generations of the map in options.shards worker processes, each owning a stripe of rows, then print a summary like runHeadless does. Linux only. Returns the exit code for main.
+
+#endif
\ No newline at end of file
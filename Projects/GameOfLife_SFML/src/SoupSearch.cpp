@@ -0,0 +1,237 @@
+#include "SoupSearch.h"
+#include "Cell.h"
+#include "FileProcessing.h"
+#include "Options.h"
+#include "ObjectSeparation.h"
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <map>
+#include <random>
+#include <utility>
+#include <functional>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace {
+	constexpr Cells::generationType defaultMaxGenerations = 50000; //Soups that have not stabilized by then are reported as such.
+	constexpr Position::coordType escapeDistance = 128; //Cells this far outside the soup have escaped (gliders and other spaceships). They are removed, so that the rest can be seen to stabilize.
+	constexpr std::size_t exampleSeedCount = 3; //Seeds listed for each line of the census.
+	constexpr std::size_t maxObjectKinds = 50; //Lines of the object census.
+
+	class SoupResult {
+	public:
+		std::uint64_t seed{ 0 };
+		Cells::generationType generations{ 0 }; //Until the repetition was noticed, or the limit.
+		WorldStatistics::size_type population{ 0 };
+		WorldStatistics::size_type escapedCells{ 0 };
+		CycleDetector::Cycle cycle; //Period 0 if the soup did not stabilize.
+	};
+
+	class ThreadResults {
+	public:
+		std::vector<SoupResult> soups;
+		objectCensusType objects; //Of the final worlds of all soups.
+	};
+
+	class CensusEntry {
+	public:
+		unsigned long long soups{ 0 };
+		std::vector<std::uint64_t> seeds; //The lowest few.
+	};
+
+	WorldStatistics::size_type removeEscapedCells(Cells &cells, int soupSize, Cells::changeContainerType &edits) {
+		Position boundingBoxMin = cells.getStatistics().getBoundingBoxMin(), boundingBoxMax = cells.getStatistics().getBoundingBoxMax();
+		auto escaped = [soupSize](Position pos) {
+			return pos.x < -escapeDistance || pos.y < -escapeDistance || pos.x >= soupSize + escapeDistance || pos.y >= soupSize + escapeDistance;
+		};
+		if (!escaped(boundingBoxMin) && !escaped(boundingBoxMax))
+			return 0;
+
+		edits.clear();
+		cells.forEachAliveCell([&](Position pos) {
+			if (escaped(pos))
+				edits.emplace_back(pos, false);
+		});
+
+		WorldStatistics::size_type removed = edits.size();
+		cells.applyEdits(edits); //Also restarts cycle detection.
+		return removed;
+	}
+
+	template<typename F> SoupResult runSoup(const Parser &rules, std::uint64_t seed, const Options &options, Cells::changeContainerType &edits, F onFinished) { //onFinished(cells) can look at the final world.
+		Cells cells;
+		cells.getRules() = rules;
+		cells.setRecordHistory(false);
+		cells.setCycleDetection(true);
+
+		edits = generateSoup(seed, options.soupSize);
+		cells.applyEdits(edits);
+
+		SoupResult result;
+		result.seed = seed;
+
+		Cells::generationType maxGenerations = options.generations ? options.generations : defaultMaxGenerations;
+		while (cells.getGeneration() < maxGenerations) {
+			cells.updateCells();
+			if (cells.getCycleDetector()->found()) { //Dying out counts as a still life of population 0.
+				result.cycle = cells.getCycleDetector()->getCycle();
+				break;
+			}
+
+			if (cells.getGeneration() % Cells::maintenanceInterval == 0) {
+				result.escapedCells += removeEscapedCells(cells, options.soupSize, edits);
+				cells.performMaintenance();
+			}
+		}
+
+		result.generations = cells.getGeneration();
+		result.population = cells.getStatistics().getPopulation();
+		onFinished(static_cast<const Cells&>(cells));
+		return result;
+	}
+
+	void searchSoups(const Options &options, const std::string &rulesStr, std::uint64_t firstSeed, unsigned thread, unsigned threadCount, ThreadResults &results) { //Runs soups thread, thread + threadCount, ... Shares nothing with the other threads: cells come from this thread's pools, and the rules are parsed again.
+		Parser rules;
+		rules(rulesStr);
+
+		ObjectSeparator separator(1); //The soups already keep every core busy.
+		ObjectCatalogue catalogue(RuleMasks(rules.getTransitionTable()));
+
+		Cells::changeContainerType edits; //Reused by every soup.
+		for (unsigned long long soup = thread; soup < options.soupSearch; soup += threadCount) {
+			results.soups.push_back(runSoup(rules, firstSeed + soup, options, edits, [&](const Cells &cells) {
+				addToObjectCensus(results.objects, separator(cells), catalogue);
+			}));
+		}
+	}
+
+	void addSeed(CensusEntry &entry, std::uint64_t seed) {
+		++entry.soups;
+		entry.seeds.insert(std::lower_bound(entry.seeds.begin(), entry.seeds.end(), seed), seed);
+		if (entry.seeds.size() > exampleSeedCount)
+			entry.seeds.pop_back();
+	}
+
+	void printSeeds(const CensusEntry &entry) {
+		std::cout << " (seed";
+		for (std::uint64_t seed : entry.seeds)
+			std::cout << " " << seed;
+		std::cout << ")\n";
+	}
+}
+
+Cells::changeContainerType generateSoup(std::uint64_t seed, int soupSize) {
+	std::mt19937_64 generator(seed);
+	Cells::changeContainerType soup;
+
+	std::uint64_t bits = 0;
+	int bitsLeft = 0;
+	for (Position::coordType y = 0; y < soupSize; ++y) {
+		for (Position::coordType x = 0; x < soupSize; ++x) {
+			if (!bitsLeft) {
+				bits = generator();
+				bitsLeft = 64;
+			}
+			if (bits & 1)
+				soup.emplace_back(Position{ x, y }, true);
+			bits >>= 1;
+			--bitsLeft;
+		}
+	}
+
+	return soup;
+}
+
+int runSoupSearch(const Options &options) {
+	std::string rulesStr = readFile(options.rulesFilePath);
+
+	std::uint64_t firstSeed = options.seed;
+	if (!options.seedGiven)
+		firstSeed = (std::uint64_t(std::random_device()()) << 32) | std::random_device()();
+
+	unsigned threadCount = options.threads ? options.threads : std::max(std::thread::hardware_concurrency(), 1u);
+	threadCount = static_cast<unsigned>(std::min<unsigned long long>(threadCount, options.soupSearch));
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<ThreadResults> threadResults(threadCount);
+	std::vector<std::thread> threads;
+	for (unsigned thread = 0; thread < threadCount; ++thread)
+		threads.emplace_back(searchSoups, std::cref(options), std::cref(rulesStr), firstSeed, thread, threadCount, std::ref(threadResults[thread]));
+	for (std::thread &thread : threads)
+		thread.join();
+
+	auto timeTaken = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+	//Census.
+	std::map<std::pair<CycleDetector::generationType, WorldStatistics::size_type>, CensusEntry> populations; //By period, then final population.
+	std::map<CycleDetector::generationType, CensusEntry> periods;
+	CensusEntry unstabilized, moving;
+	objectCensusType objects;
+	unsigned long long generations = 0, escapedCells = 0;
+
+	for (auto &results : threadResults) {
+		for (auto &pair : results.objects)
+			objects[pair.first] += pair.second;
+
+		for (SoupResult &result : results.soups) {
+			generations += result.generations;
+			escapedCells += result.escapedCells;
+
+			if (!result.cycle.period) {
+				addSeed(unstabilized, result.seed);
+				continue;
+			}
+			if (result.cycle.displacement != Position{ 0, 0 })
+				addSeed(moving, result.seed);
+			addSeed(periods[result.cycle.period], result.seed);
+			addSeed(populations[std::make_pair(result.cycle.period, result.population)], result.seed);
+		}
+	}
+
+	std::cout << "Soups: " << options.soupSearch << " of " << options.soupSize << "x" << options.soupSize << ", seeds " << firstSeed << " to " << firstSeed + options.soupSearch - 1 << ", " << threadCount << " threads\n";
+	std::cout << "Time: " << timeTaken.count() << " ms, " << generations << " generations\n";
+	std::cout << "Cells that escaped: " << escapedCells << "\n";
+
+	if (unstabilized.soups) {
+		std::cout << "Not stabilized within " << (options.generations ? options.generations : defaultMaxGenerations) << " generations: " << unstabilized.soups;
+		printSeeds(unstabilized);
+	}
+	if (moving.soups) {
+		std::cout << "Ended as a single moving object: " << moving.soups;
+		printSeeds(moving);
+	}
+
+	std::cout << "Periods:\n";
+	for (auto &pair : periods) {
+		std::cout << "  " << pair.first << ": " << pair.second.soups;
+		printSeeds(pair.second);
+	}
+
+	std::cout << "Final populations (period, population: soups):\n";
+	for (auto &pair : populations) {
+		std::cout << "  " << pair.first.first << ", " << pair.first.second << ": " << pair.second.soups;
+		printSeeds(pair.second);
+	}
+
+	std::cout << "Objects in the final worlds:\n";
+	writeObjectCensus(std::cout, objects, maxObjectKinds);
+
+	if (options.soupSearch == 1) { //So a single soup can be opened as a map.
+		std::cout << "Soup:\n";
+		Cells::changeContainerType soup = generateSoup(firstSeed, options.soupSize);
+		std::string map(options.soupSize * (options.soupSize + 1), ' ');
+		for (Position::coordType y = 0; y < options.soupSize; ++y)
+			map[y * (options.soupSize + 1) + options.soupSize] = '\n';
+		for (auto &cell : soup)
+			map[cell.first.y * (options.soupSize + 1) + cell.first.x] = '*';
+		std::cout << map;
+	}
+
+	return 0;
+}
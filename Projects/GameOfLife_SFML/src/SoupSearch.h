@@ -0,0 +1,12 @@
+#ifndef SOUPSEARCH_H
+#define SOUPSEARCH_H
+
+#include "Options.h"
+#include "Cell.h"
+
+#include <cstdint>
+
+Cells::changeContainerType generateSoup(std::uint64_t seed, int soupSize); //The alive cells of a soupSize x soupSize square in which each cell is alive with a probability of 1/2. The same for the same seed.
+int runSoupSearch(const Options &options); //Run options.soupSearch random soups on all cores until each one stabilizes, then print a census of their final populations and periods. Returns the exit code for main.
+
+#endif
\ No newline at end of file
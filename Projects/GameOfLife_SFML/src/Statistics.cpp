@@ -0,0 +1,49 @@
+#include "Statistics.h"
+
+void WorldStatistics::update(Position pos, bool alive) {
+	if (alive) {
+		++population;
+		++births;
+	}
+	else {
+		--population;
+		++deaths;
+	}
+
+	updateLineCount(rowCounts, pos.y, alive);
+	updateLineCount(columnCounts, pos.x, alive);
+}
+
+void WorldStatistics::nextGeneration() {
+	births = 0;
+	deaths = 0;
+}
+
+void WorldStatistics::clear() {
+	rowCounts.clear();
+	columnCounts.clear();
+	population = 0;
+	nextGeneration();
+}
+
+Position WorldStatistics::getBoundingBoxMin() const {
+	if (empty())
+		return Position{ 0, 0 };
+	return Position{ columnCounts.begin()->first, rowCounts.begin()->first };
+}
+
+Position WorldStatistics::getBoundingBoxMax() const {
+	if (empty())
+		return Position{ 0, 0 };
+	return Position{ columnCounts.rbegin()->first, rowCounts.rbegin()->first };
+}
+
+void WorldStatistics::updateLineCount(lineCountContainerType &lineCounts, Position::coordType line, bool alive) {
+	if (alive)
+		++lineCounts[line];
+	else {
+		auto it = lineCounts.find(line);
+		if (it != lineCounts.end() && --it->second == 0)
+			lineCounts.erase(it);
+	}
+}
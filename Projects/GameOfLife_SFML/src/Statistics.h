@@ -0,0 +1,50 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "Position.h"
+#include "PoolAllocator.h"
+
+#include <cstddef>
+#include <map>
+#include <functional>
+#include <utility>
+
+class WorldStatistics { //Population, bounding box, births and deaths of the world. Updated with each change instead of by looking through all cells.
+public:
+	typedef std::size_t size_type;
+
+	void update(Position pos, bool alive); //Called for each cell that was born (alive) or died (!alive).
+	void nextGeneration(); //Starts counting the births and deaths of a new generation.
+	void clear();
+
+	size_type getPopulation() const noexcept {
+		return population;
+	}
+
+	size_type getBirths() const noexcept { //Of the last generation.
+		return births;
+	}
+
+	size_type getDeaths() const noexcept { //Of the last generation.
+		return deaths;
+	}
+
+	bool empty() const noexcept {
+		return population == 0;
+	}
+
+	Position getBoundingBoxMin() const; //Top left corner of the bounding box of all alive cells. (0, 0) if there are none.
+	Position getBoundingBoxMax() const; //Bottom right corner, inclusive.
+
+private:
+	typedef std::map<Position::coordType, size_type, std::less<Position::coordType>, PoolAllocator<std::pair<const Position::coordType, size_type>, MemoryAccounting::statistics>> lineCountContainerType; //Amount of alive cells in each row/column. The first and last keys form the bounding box.
+
+	static void updateLineCount(lineCountContainerType &lineCounts, Position::coordType line, bool alive);
+
+	lineCountContainerType rowCounts, columnCounts;
+	size_type population{ 0 };
+	size_type births{ 0 };
+	size_type deaths{ 0 };
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "TileCache.h"
+
+#include <algorithm>
+
+void TileCache::update(Position pos, bool alive) {
+	Position tilePos{ floorDivide(pos.x), floorDivide(pos.y) };
+	Position local{ pos.x - tilePos.x * tileSize, pos.y - tilePos.y * tileSize };
+
+	Tile &tile = tiles[tilePos];
+	const sf::Color &aliveColor = sf::Color::Green; //The same color as cells drawn without the cache.
+	sf::Uint8 *pixel = &tile.pixels[(std::size_t(local.y) * tileSize + local.x) * 4];
+	pixel[0] = aliveColor.r;
+	pixel[1] = aliveColor.g;
+	pixel[2] = aliveColor.b;
+	pixel[3] = alive ? aliveColor.a : 0; //Dead cells are transparent.
+
+	if (alive)
+		++tile.aliveCount;
+	else if (tile.aliveCount)
+		--tile.aliveCount;
+
+	if (tile.dirtyBegin >= tile.dirtyEnd) {
+		tile.dirtyBegin = local.y;
+		tile.dirtyEnd = local.y + 1;
+	}
+	else {
+		tile.dirtyBegin = std::min(tile.dirtyBegin, local.y);
+		tile.dirtyEnd = std::max(tile.dirtyEnd, local.y + 1);
+	}
+}
+
+void TileCache::clear() {
+	tiles.clear();
+}
+
+void TileCache::removeEmptyTiles() {
+	for (auto it = tiles.begin(); it != tiles.end();) {
+		if (!it->second.aliveCount)
+			it = tiles.erase(it);
+		else
+			++it;
+	}
+}
+
+void TileCache::render(sf::RenderTarget &target, sf::FloatRect visibleArea, sf::Vector2f cellSize, Position cameraOrigin) {
+	const sf::Vector2f tileWorldSize(tileSize * cellSize.x, tileSize * cellSize.y);
+
+	for (auto &pair : tiles) {
+		Tile &tile = pair.second;
+		if (!tile.aliveCount)
+			continue;
+
+		const Position tileOrigin = Position{ pair.first.x * tileSize, pair.first.y * tileSize } - cameraOrigin; //In cells.
+		const sf::Vector2f topLeft(static_cast<float>(tileOrigin.x) * cellSize.x, static_cast<float>(tileOrigin.y) * cellSize.y);
+		if (topLeft.x > visibleArea.left + visibleArea.width || topLeft.x + tileWorldSize.x < visibleArea.left ||
+			topLeft.y > visibleArea.top + visibleArea.height || topLeft.y + tileWorldSize.y < visibleArea.top)
+			continue; //Not visible. It is uploaded once it comes into view.
+
+		if (!tile.textureCreated) {
+			tile.texture.create(tileSize, tileSize);
+			tile.textureCreated = true;
+			tile.dirtyBegin = 0;
+			tile.dirtyEnd = tileSize;
+		}
+
+		if (tile.dirtyBegin < tile.dirtyEnd) {
+			tile.texture.update(&tile.pixels[std::size_t(tile.dirtyBegin) * tileSize * 4], tileSize, tile.dirtyEnd - tile.dirtyBegin, 0, tile.dirtyBegin);
+			tile.dirtyBegin = tile.dirtyEnd = 0;
+		}
+
+		const sf::Vertex quad[] = {
+			sf::Vertex(topLeft, sf::Vector2f(0, 0)),
+			sf::Vertex(sf::Vector2f(topLeft.x + tileWorldSize.x, topLeft.y), sf::Vector2f(tileSize, 0)),
+			sf::Vertex(sf::Vector2f(topLeft.x + tileWorldSize.x, topLeft.y + tileWorldSize.y), sf::Vector2f(tileSize, tileSize)),
+			sf::Vertex(sf::Vector2f(topLeft.x, topLeft.y + tileWorldSize.y), sf::Vector2f(0, tileSize))
+		};
+		target.draw(quad, 4, sf::Quads, sf::RenderStates(&tile.texture));
+	}
+}
@@ -0,0 +1,54 @@
+#ifndef TILECACHE_H
+#define TILECACHE_H
+
+#include "Position.h"
+#include "MemoryAccounting.h"
+#include "ChangeListener.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+
+class TileCache : public ChangeListener { //Alive cells drawn into tiles of 64x64 pixels, one pixel per cell. Only the rows of a tile changed since it was last drawn are uploaded again, and each tile is drawn as a single textured quad.
+public:
+	typedef std::size_t size_type;
+
+	static constexpr Position::coordType tileSize = 64; //In cells.
+
+	void update(Position pos, bool alive) override;
+	void clear() override;
+	void removeEmptyTiles();
+
+	void maintain() override {
+		removeEmptyTiles();
+	}
+	void render(sf::RenderTarget &target, sf::FloatRect visibleArea, sf::Vector2f cellSize, Position cameraOrigin); //visibleArea is in view coordinates, in which cameraOrigin is at (0, 0).
+
+	size_type getTileCount() const noexcept {
+		return tiles.size();
+	}
+
+private:
+	typedef std::vector<sf::Uint8, TaggedAllocator<sf::Uint8, MemoryAccounting::rendering>> pixelContainerType;
+
+	class Tile {
+	public:
+		Tile() : pixels(tileSize * tileSize * 4, 0) {}
+
+		pixelContainerType pixels; //RGBA, row by row.
+		sf::Texture texture; //Created the first time the tile is drawn, as it needs a window.
+		size_type aliveCount{ 0 };
+		Position::coordType dirtyBegin{ 0 }, dirtyEnd{ tileSize }; //Rows that have to be uploaded.
+		bool textureCreated{ false };
+	};
+
+	static Position::coordType floorDivide(Position::coordType value) noexcept { //Rounds towards negative infinity, unlike /.
+		return (value >= 0 ? value : value - (tileSize - 1)) / tileSize;
+	}
+
+	std::unordered_map<Position, Tile, MortonHasher> tiles; //By the position of the tile, in tiles.
+};
+
+#endif
\ No newline at end of file
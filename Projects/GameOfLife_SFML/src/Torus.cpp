@@ -0,0 +1,23 @@
+#include "Torus.h"
+
+#include <stdexcept>
+#include <algorithm>
+
+TorusGrid::TorusGrid(Position::coordType w, Position::coordType h) : width{ w }, height{ h }, stride{ std::size_t(w) + 2 } {
+	if (w <= 0 || h <= 0)
+		throw(std::logic_error("Map Syntax Error: A wrapping map must be at least one cell wide and one cell high."));
+
+	current.assign(stride * (std::size_t(h) + 2), 0);
+	next = current;
+}
+
+void TorusGrid::refreshHalo() {
+	for (Position::coordType y = 0; y < height; ++y) { //Left and right halo columns.
+		current[index(-1, y)] = current[index(width - 1, y)];
+		current[index(width, y)] = current[index(0, y)];
+	}
+
+	//Top and bottom halo rows, including the corners.
+	std::copy_n(current.begin() + index(-1, height - 1), stride, current.begin() + index(-1, -1));
+	std::copy_n(current.begin() + index(-1, 0), stride, current.begin() + index(-1, height));
+}
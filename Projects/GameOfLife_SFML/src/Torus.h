@@ -0,0 +1,93 @@
+#ifndef TORUS_H
+#define TORUS_H
+
+#include "Position.h"
+#include "MemoryAccounting.h"
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+class TorusGrid { //Bounded world whose edges wrap around (Extension 2). Cells are stored densely in two buffers; one holds the current tick, the other receives the next one.
+public:
+	typedef unsigned char stateType;
+	typedef std::vector<stateType, TaggedAllocator<stateType, MemoryAccounting::grid>> gridContainerType;
+
+	TorusGrid(Position::coordType w, Position::coordType h);
+
+	bool getAlive(Position pos) const {
+		return current[index(pos.x, pos.y)] != 0;
+	}
+
+	void setAlive(Position pos, bool alive) {
+		current[index(pos.x, pos.y)] = alive;
+	}
+
+	Position::coordType getWidth() const noexcept {
+		return width;
+	}
+
+	Position::coordType getHeight() const noexcept {
+		return height;
+	}
+
+	const stateType *getRow(Position::coordType y) const noexcept { //width cells, 1 if alive. Row y + 1 starts getStride() cells later. Valid until the next step, which swaps the buffers.
+		return &current[index(0, y)];
+	}
+
+	std::size_t getStride() const noexcept {
+		return stride;
+	}
+
+	Position wrap(Position pos) const noexcept { //The position inside the grid that pos refers to.
+		return Position{ ((pos.x % width) + width) % width, ((pos.y % height) + height) % height };
+	}
+
+	template<typename Kernel, typename F> void step(Kernel kernel, F onChange); //Kernel is one of the rule kernels. Calls onChange(Position, bool) for each cell that changed.
+
+	template<typename F> void forEachAlive(F f) const {
+		for (Position::coordType y = 0; y < height; ++y) {
+			const stateType *row = &current[index(0, y)];
+			for (Position::coordType x = 0; x < width; ++x) {
+				if (row[x])
+					f(Position{ x, y });
+			}
+		}
+	}
+
+private:
+	std::size_t index(Position::coordType x, Position::coordType y) const noexcept { //Skips the halo.
+		return (std::size_t(y) + 1) * stride + std::size_t(x) + 1;
+	}
+
+	void refreshHalo();
+
+	gridContainerType current, next; //Each row is padded by a halo column on both sides, and a halo row is added above and below the grid.
+	Position::coordType width, height;
+	std::size_t stride; //width + 2.
+};
+
+template<typename Kernel, typename F> void TorusGrid::step(Kernel kernel, F onChange) {
+	refreshHalo(); //The halo now mirrors the opposite edges, so neighbors can be read without wrapping coordinates.
+
+	for (Position::coordType y = 0; y < height; ++y) {
+		const stateType *above = &current[index(0, y - 1)];
+		const stateType *middle = &current[index(0, y)];
+		const stateType *below = &current[index(0, y + 1)];
+		stateType *future = &next[index(0, y)];
+
+		for (Position::coordType x = 0; x < width; ++x) {
+			const int aliveNeighbors = above[x - 1] + above[x] + above[x + 1] + middle[x - 1] + middle[x + 1] + below[x - 1] + below[x] + below[x + 1];
+			const stateType alive = middle[x];
+			const stateType futureAlive = kernel(alive != 0, aliveNeighbors);
+
+			future[x] = futureAlive;
+			if (futureAlive != alive)
+				onChange(Position{ x, y }, futureAlive != 0);
+		}
+	}
+
+	std::swap(current, next);
+}
+
+#endif
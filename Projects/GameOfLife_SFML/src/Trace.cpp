@@ -0,0 +1,101 @@
+#include "Trace.h"
+
+#include <fstream>
+#include <stdexcept>
+
+std::atomic<bool> Tracer::enabled{ false };
+std::mutex Tracer::buffersMutex;
+std::vector<std::unique_ptr<Tracer::ThreadBuffer>> Tracer::buffers;
+std::string Tracer::outputFilePath;
+std::chrono::steady_clock::time_point Tracer::startTime;
+
+void Tracer::start(const std::string &filePath) {
+	{
+		std::ofstream file(filePath, std::ios::out | std::ios::trunc); //Fail now rather than after a long run.
+		if (!file.is_open())
+			throw(std::logic_error("Error opening trace output file."));
+	}
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	outputFilePath = filePath;
+	startTime = std::chrono::steady_clock::now();
+	for (auto &buffer : buffers) {
+		buffer->events.clear();
+		buffer->dropped = 0;
+		buffer->openScopes = 0;
+		buffer->openDroppedScopes = 0;
+	}
+	enabled.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop() {
+	if (!enabled.exchange(false, std::memory_order_relaxed))
+		return;
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	std::ofstream file(outputFilePath, std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+		throw(std::logic_error("Error opening trace output file."));
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	for (auto &buffer : buffers) {
+		for (const Event &event : buffer->events) {
+			if (!first)
+				file << ",";
+			first = false;
+
+			//Timestamps are in microseconds. Keep the nanoseconds as a fraction.
+			file << "\n{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << buffer->threadID
+				<< ",\"ts\":" << event.timestamp / 1000 << "." << std::to_string(1000 + event.timestamp % 1000).substr(1) << "}";
+		}
+
+		if (buffer->dropped) {
+			if (!first)
+				file << ",";
+			first = false;
+			file << "\n{\"name\":\"dropped " << buffer->dropped << " scopes\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" << buffer->threadID << ",\"ts\":0}";
+		}
+	}
+	file << "\n]}\n";
+}
+
+Tracer::ThreadBuffer &Tracer::getThreadBuffer() {
+	thread_local ThreadBuffer *threadBuffer = nullptr;
+	if (!threadBuffer) {
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		buffers.push_back(std::make_unique<ThreadBuffer>());
+		threadBuffer = buffers.back().get();
+		threadBuffer->threadID = static_cast<int>(buffers.size());
+		threadBuffer->events.reserve(4096);
+	}
+	return *threadBuffer;
+}
+
+void Tracer::record(const char *name, char phase) {
+	if (!isEnabled())
+		return;
+
+	ThreadBuffer &buffer = getThreadBuffer();
+	if (phase == 'B') {
+		if (buffer.events.size() + buffer.openScopes + 2 > maxEventsPerThread) { //No room for this begin, its end and the ends of the scopes around it. Scopes inside it are dropped too, as there is no more room for them.
+			++buffer.dropped; //Count scopes, not events.
+			++buffer.openDroppedScopes;
+			return;
+		}
+		++buffer.openScopes;
+	}
+	else if (buffer.openDroppedScopes) { //Scopes nest, so this ends the innermost dropped scope.
+		--buffer.openDroppedScopes;
+		return;
+	}
+	else if (buffer.openScopes) {
+		--buffer.openScopes;
+	}
+	else { //Its begin was recorded before the trace was restarted.
+		return;
+	}
+
+	auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime);
+	buffer.events.push_back(Event{ name, timestamp.count(), phase });
+}
@@ -0,0 +1,90 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <memory>
+#include <mutex>
+
+//Timeline of individual ticks, frames, maintenance and history operations, written as a Chrome trace-event JSON file (open it in Perfetto or chrome://tracing).
+//Every thread records into its own buffer, so recording takes no locks. Define GOL_NO_PROFILING to compile all trace points out.
+
+class Tracer {
+public:
+	static constexpr std::size_t maxEventsPerThread = 1 << 22; //Further scopes are dropped whole, so a forgotten trace does not use up all memory.
+
+	static void start(const std::string &filePath); //Start recording. The file is written by stop.
+	static void stop(); //Write every thread's events to the file. Threads that recorded events must have finished.
+
+	static bool isEnabled() noexcept {
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	static void begin(const char *name) { //name must outlive the tracer. String literals are used everywhere.
+		record(name, 'B');
+	}
+
+	static void end(const char *name) {
+		record(name, 'E');
+	}
+
+private:
+	class Event {
+	public:
+		const char *name;
+		std::int64_t timestamp; //Nanoseconds since start.
+		char phase; //'B' or 'E', as in the trace-event format.
+	};
+
+	class ThreadBuffer {
+	public:
+		std::vector<Event> events;
+		std::size_t dropped{ 0 };
+		std::size_t openScopes{ 0 }; //Recorded begins still waiting for their end. Room is kept for those ends.
+		std::size_t openDroppedScopes{ 0 }; //Dropped begins still waiting for their end, which is dropped as well.
+		int threadID{ 0 };
+	};
+
+	static void record(const char *name, char phase);
+	static ThreadBuffer &getThreadBuffer(); //Registers the calling thread's buffer the first time it is called on that thread.
+
+	static std::atomic<bool> enabled;
+	static std::mutex buffersMutex; //Only taken when a thread records its first event, and when starting and stopping.
+	static std::vector<std::unique_ptr<ThreadBuffer>> buffers; //Owned here, so events outlive the threads that recorded them.
+	static std::string outputFilePath;
+	static std::chrono::steady_clock::time_point startTime;
+};
+
+class ScopedTrace { //Records a begin event on construction and the matching end event on destruction.
+public:
+	ScopedTrace(const char *n) : name{ n }, active{ Tracer::isEnabled() } {
+		if (active)
+			Tracer::begin(name);
+	}
+	ScopedTrace(const ScopedTrace&) = delete;
+	ScopedTrace &operator=(const ScopedTrace&) = delete;
+
+	~ScopedTrace() {
+		if (active)
+			Tracer::end(name);
+	}
+
+private:
+	const char *name;
+	bool active; //An end without its begin would confuse the viewer, so decide once.
+};
+
+#define TRACE_CONCATENATE_IMPLEMENTATION(a, b) a##b
+#define TRACE_CONCATENATE(a, b) TRACE_CONCATENATE_IMPLEMENTATION(a, b)
+
+#ifndef GOL_NO_PROFILING
+#define TRACE_SCOPE(name) ScopedTrace TRACE_CONCATENATE(scopedTrace, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name)
+#endif
+
+#endif
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "Window.h"
 
+#include <cmath>
+
 void Window::zoom(sf::Vector2f mousePos, bool zoomIn) { //Second arguments is positive if zooming in, negative if zooming out.
 	constexpr float changeCenterToMouseCoords = 2; //Affects affinity of the center of the window towards the mouse.
 	constexpr float zoomInMovementChange = 0.1f;
@@ -25,5 +27,17 @@ void Window::zoom(sf::Vector2f mousePos, bool zoomIn) { //Second arguments is po
 			zoomInSum -= zoomInMovementChange;
 	}
 
+	window.setView(view);
+}
+
+void Window::updateCameraOrigin(sf::Vector2f cellSize) {
+	sf::Vector2f center = view.getCenter();
+	if (std::abs(center.x) < maxCameraDistance && std::abs(center.y) < maxCameraDistance)
+		return;
+
+	//Whole cells, so cells stay aligned with the pixels they were drawn on.
+	Position offset{ static_cast<Position::coordType>(std::floor(center.x / cellSize.x)), static_cast<Position::coordType>(std::floor(center.y / cellSize.y)) };
+	cameraOrigin = cameraOrigin + offset;
+	view.move(-static_cast<float>(offset.x) * cellSize.x, -static_cast<float>(offset.y) * cellSize.y);
 	window.setView(view);
 }
\ No newline at end of file
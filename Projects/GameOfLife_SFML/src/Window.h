@@ -1,6 +1,7 @@
 #ifndef WINDOW_H
 #define WINDOW_H
 #include "Map.h"
+#include "Position.h"
 
 #include <SFML/Graphics.hpp>
 
@@ -30,9 +31,18 @@ public:
 
 	void zoom(sf::Vector2f mousePos, bool zoomIn);
 
+	Position getCameraOrigin() const noexcept { //The cell drawn at (0, 0) of the view. Everything is drawn relative to it, as floats lose precision far from zero.
+		return cameraOrigin;
+	}
+
+	void updateCameraOrigin(sf::Vector2f cellSize); //Move the camera origin to the center of the view once the view has moved far from it. Called before drawing.
+
 private:
+	static constexpr float maxCameraDistance = 1 << 20; //From the camera origin, in view coordinates. Floats are exact to 1/16 of a pixel below this.
+
 	sf::RenderWindow window;
 	sf::View view;
+	Position cameraOrigin{ 0, 0 };
 	float zoomInSum{ 1 };
 };
 
@@ -0,0 +1,24 @@
+#include "WorldView.h"
+#include "Cell.h"
+
+WorldView::AliveCells WorldView::getAliveCells() {
+	if (!gathered || gatheredChangeCount != cells.getChangeCount()) {
+		positions.clear();
+		positions.reserve(cells.getStatistics().getPopulation());
+		cells.forEachAliveCell([this](Position pos) {
+			positions.push_back(pos);
+		});
+		gatheredChangeCount = cells.getChangeCount();
+		gathered = true;
+	}
+
+	return AliveCells{ positions.data(), positions.size() };
+}
+
+WorldView::Grid WorldView::getGrid() const {
+	const TorusGrid *torus = cells.getTorus();
+	if (!torus)
+		return Grid{};
+
+	return Grid{ torus->getRow(0), torus->getWidth(), torus->getHeight(), torus->getStride() };
+}
@@ -0,0 +1,61 @@
+#ifndef WORLDVIEW_H
+#define WORLDVIEW_H
+
+#include "Position.h"
+#include "Torus.h"
+#include "MemoryAccounting.h"
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class Cells;
+
+class WorldView { //Read-only access to the alive cells of a world for programs that embed the simulation, without copying them for every query. What it returns stays valid until the world changes: the next tick, edit or load. The cells that changed in the last tick are in Cells::getLastChanges.
+public:
+	class AliveCells { //Positions packed one after another, in no particular order.
+	public:
+		const Position *begin() const noexcept {
+			return positions;
+		}
+
+		const Position *end() const noexcept {
+			return positions + count;
+		}
+
+		std::size_t size() const noexcept {
+			return count;
+		}
+
+		const Position *positions{ nullptr };
+		std::size_t count{ 0 };
+	};
+
+	class Grid { //The cells of a world that wraps around, one byte each, 1 if alive. Not a copy: points into the world itself.
+	public:
+		const TorusGrid::stateType *getRow(Position::coordType y) const noexcept {
+			return cells + std::size_t(y) * stride;
+		}
+
+		bool getAlive(Position pos) const noexcept { //pos must be inside the grid.
+			return getRow(pos.y)[pos.x] != 0;
+		}
+
+		const TorusGrid::stateType *cells{ nullptr }; //First cell of the top row. nullptr if the world is infinite.
+		Position::coordType width{ 0 }, height{ 0 };
+		std::size_t stride{ 0 }; //Cells from the start of one row to the start of the next.
+	};
+
+	explicit WorldView(const Cells &cells) : cells{ cells } {}
+
+	AliveCells getAliveCells(); //Gathered again only if the world changed since the last call.
+	Grid getGrid() const;
+
+private:
+	const Cells &cells;
+	std::vector<Position, TaggedAllocator<Position, MemoryAccounting::views>> positions;
+	std::uint64_t gatheredChangeCount{ 0 };
+	bool gathered = false;
+};
+
+#endif
\ No newline at end of file
@@ -1,24 +1,83 @@
 #include <iostream>
 #include <chrono>
 #include <string>
-
-#include <SFML/Graphics.hpp>
+#include <cstdint>
 
 #include "Cell.h"
 #include "FileProcessing.h"
+#include "Options.h"
+#include "Headless.h"
+#include "Benchmark.h"
+#include "SoupSearch.h"
+#include "ShardedSimulation.h"
+#include "EngineComparison.h"
+#include "FrameExport.h"
+#include "Profiler.h"
+#include "Trace.h"
+
+#ifndef GOL_NO_WINDOW //Defined by builds without SFML, which only run without a window.
+#include <SFML/Graphics.hpp>
+
 #include "Window.h"
 #include "HandleInput.h"
 #include "GUI.h"
+#include "HUD.h"
+#include "Editor.h"
+#include "CellRenderer.h"
+#include "FrameScheduler.h"
 
 constexpr auto assetsFilePath = "..\\assets\\bitmap.jpg";
+#endif
+
+namespace {
+	bool isBatchRun(int argc, char **argv) { //Runs without a window fail without waiting for anyone, so scripts and CI jobs do not hang. Checked on the raw arguments, as the options may be what failed.
+		for (int i = 1; i < argc; ++i) {
+			const std::string flag = argv[i];
+			if (flag == "--generations" || flag == "--soup-search" || flag == "--compare" || flag == "--shards" || flag == "--benchmark")
+				return true;
+		}
+#ifdef GOL_NO_WINDOW
+		return true;
+#else
+		return false;
+#endif
+	}
+}
 
 int main(int argc, char **argv) {
 	//Process the map/rules file, and then construct the map.
 	Cells cells;
+	Options options;
+#ifndef GOL_NO_WINDOW
+	FrameExporter::setImageWriter([](const std::string &filePath, const std::uint8_t *pixels, Position size) {
+		sf::Image image;
+		image.create(static_cast<unsigned>(size.x), static_cast<unsigned>(size.y), pixels);
+		return image.saveToFile(filePath);
+	});
+	Editor editor;
+#endif
 	try {
-		processMapRuleFiles(argv, argc, &cells);
+		options = Options(argc, argv);
+		if (options.soupSearch)
+			return runSoupSearch(options);
+		if (!options.compareEngines.empty())
+			return runEngineComparison(options);
+		if (options.shards) //The whole world is never loaded into this process.
+			return runSharded(options);
+		processMapRuleFiles(options, &cells);
+		if (options.benchmark)
+			return runBenchmark(options);
+#ifndef GOL_NO_WINDOW
+		if (!options.patternFilePath.empty())
+			editor.setPattern(readFile(options.patternFilePath));
+#endif
 	}
 	catch (std::exception &le) {
+		if (isBatchRun(argc, argv)) {
+			std::cerr << le.what() << "\n";
+			return -1;
+		}
+
 		std::cerr << le.what() << "\n Press enter to continue.";
 		std::string str;
 		std::getline(std::cin, str);
@@ -28,12 +87,43 @@ int main(int argc, char **argv) {
 
 	auto &rules = cells.getRules();
 
+	if (options.zOrder)
+		cells.setZOrder(true);
+
+	if (!options.profileCSVFilePath.empty())
+		Profiler::get().setCSVOutput(options.profileCSVFilePath);
+	if (!options.traceFilePath.empty())
+		Tracer::start(options.traceFilePath);
+	cells.setAutosave(options.autosaveFilePath, std::chrono::seconds(options.autosaveInterval));
+
+	if (options.generations) {
+		int result = -1;
+		try {
+			result = runHeadless(cells, options);
+		}
+		catch (std::exception &e) {
+			std::cerr << e.what() << "\n";
+		}
+		Tracer::stop();
+		return result;
+	}
+
+#ifdef GOL_NO_WINDOW
+	std::cerr << "This build has no window. Pass --generations N to run without one.\n";
+	return -1;
+#else
+
+	if (options.stopOnCycle) {
+		cells.setCycleDetection(true);
+		cells.setPauseOnCycle(true);
+	}
+
 	Window window(sf::VideoMode::getDesktopMode(), ".___.");
 	window.getSFMLWindow().setVerticalSyncEnabled(false);
 
-	sf::Texture texture;
-	texture.loadFromFile(assetsFilePath);
-	GUIs guis(texture); //Create guis.
+	sf::Image buttonImage;
+	buttonImage.loadFromFile(assetsFilePath);
+	GUIs guis(buttonImage); //Create guis.
 	{
 		guis.emplace<RewindButton>(sf::FloatRect(window.getSFMLWindow().getSize().x / 2 - 120, window.getSFMLWindow().getSize().y - 60, 60, 60), cells);
 		guis.emplace<StepBackwardButton>(sf::FloatRect(window.getSFMLWindow().getSize().x / 2 - 60, window.getSFMLWindow().getSize().y - 60, 60, 60), cells);
@@ -41,36 +131,44 @@ int main(int argc, char **argv) {
 		guis.emplace<StepForwardButton>(sf::FloatRect(window.getSFMLWindow().getSize().x / 2 + 60, window.getSFMLWindow().getSize().y - 60, 60, 60), cells);
 		guis.emplace<FastForwardButton>(sf::FloatRect(window.getSFMLWindow().getSize().x / 2 + 120, window.getSFMLWindow().getSize().y - 60, 60, 60), cells);
 	}
+	HUD &hud = guis.emplace<HUD>(cells, editor);
+	JumpControls &jumpControls = guis.emplace<JumpControls>(sf::Vector2f(6, window.getSFMLWindow().getSize().y - 66), cells);
 
-	auto start = std::chrono::steady_clock::now(), end = std::chrono::steady_clock::now();
-	auto lastFrameTime = std::chrono::nanoseconds(0), timePassed = std::chrono::nanoseconds(0);
-	for (bool done = false; !done;) { //Game loop.
-		start = std::chrono::steady_clock::now();
+	CellRenderer cellRenderer(cells);
+	cellRenderer.setTileCache(true);
 
-		if (timePassed > minTimeBetweenEachFrame) {
+	FrameScheduler scheduler(window.getSFMLWindow(), minTimeBetweenEachFrame);
+	for (bool done = false; !done;) { //Game loop.
+		if (scheduler.frameDue()) {
+			TRACE_SCOPE("frame");
 			window.getSFMLWindow().clear(sf::Color::Black);
-			cells.render(window); //Render cells.
-			guis.render(window);
-			window.getSFMLWindow().display();
+			cellRenderer.render(window); //Render cells.
+			{
+				PROFILE_SCOPE(renderingGUI);
+				guis.render(window);
+			}
+			{
+				PROFILE_SCOPE(display);
+				window.getSFMLWindow().display();
+			}
 
-			timePassed = std::chrono::nanoseconds(0);
+			scheduler.frameRendered();
 		}
 
-		cells.update(); //Update all cells. (start of a tick)
-
-		end = std::chrono::steady_clock::now();
-		lastFrameTime = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-		timePassed += lastFrameTime;
+		if (cells.update()) //Update all cells. (start of a tick)
+			scheduler.requestFrame();
 
-		for (sf::Event event; window.getSFMLWindow().pollEvent(event);)
+		//Sleep until the next tick or frame is due, handling events in the meantime.
+		for (sf::Event event; !done && scheduler.waitEvent(event, cells.getNextUpdateTime());)
 		{
+			PROFILE_SCOPE(handlingEvents);
 			switch (event.type) {
 			case sf::Event::Closed:
 				done = true;
 				break;
 
 			case sf::Event::KeyPressed:
-				handleKeyPressed(event.key, window);
+				handleKeyPressed(event.key, window, hud, editor, jumpControls);
 				break;
 
 			case sf::Event::MouseWheelScrolled:
@@ -78,9 +176,16 @@ int main(int argc, char **argv) {
 				break;
 
 			case::sf::Event::MouseButtonPressed:
-				handleMouseButtonPressed(event.mouseButton, window, guis, cells);
+				handleMouseButtonPressed(event.mouseButton, window, guis, cells, editor);
+				break;
+
+			case sf::Event::MouseButtonReleased:
+				handleMouseButtonReleased(event.mouseButton, window, cells, editor);
 				break;
 			}
 		}
 	}
+
+	Tracer::stop();
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "Testing.h"
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+	const char *glider = " *\n  *\n***"; //Moves by (1, 1) every 4 generations.
+	const char *reversedGlider = "***\n*\n *"; //Moves by (-1, -1).
+
+	std::vector<Position> getAliveCells(const Cells &cells) { //Sorted, to compare worlds.
+		std::vector<Position> alive;
+		cells.forEachAliveCell([&](Position pos) {
+			alive.push_back(pos);
+		});
+		std::sort(alive.begin(), alive.end(), [](Position pos1, Position pos2) {
+			return pos1.y < pos2.y || (pos1.y == pos2.y && pos1.x < pos2.x);
+		});
+		return alive;
+	}
+
+	void findCycle(Cells &cells) {
+		cells.setCycleDetection(true);
+		while (!cells.getCycleDetector()->found())
+			cells.updateCells();
+	}
+
+	void runTo(Cells &cells, Cells::generationType generation) { //Skipping every whole period on the way.
+		while (cells.getGeneration() < generation) {
+			cells.updateCells();
+			cells.skipCycles(generation);
+		}
+	}
+
+	void testSkippingMatchesSimulating() {
+		for (bool wrapAround : { false, true }) {
+			Cells skipped, simulated;
+			testing::loadWorld(skipped, wrapAround ? "#*####\n##*###\n***###\n######\n######\n######" : glider, wrapAround);
+			testing::loadWorld(simulated, wrapAround ? "#*####\n##*###\n***###\n######\n######\n######" : glider, wrapAround);
+
+			findCycle(skipped);
+			runTo(skipped, 1001);
+			while (simulated.getGeneration() < 1001)
+				simulated.updateCells();
+
+			CHECK(skipped.getGeneration() == 1001);
+			CHECK(getAliveCells(skipped) == getAliveCells(simulated));
+		}
+	}
+
+	void testSkippingFarInAWorldThatWrapsAround() { //Only the displacement modulo the size of the world matters, so it never overflows.
+		Cells far, near;
+		testing::loadWorld(far, "#*####\n##*###\n***###\n######\n######\n######", true);
+		testing::loadWorld(near, "#*####\n##*###\n***###\n######\n######\n######", true);
+
+		findCycle(far);
+		runTo(far, 10000000003ull);
+		runTo(near, 10000000003ull % 24); //The glider is back where it started after 24 generations.
+
+		CHECK(far.getGeneration() == 10000000003ull);
+		CHECK(getAliveCells(far) == getAliveCells(near));
+	}
+
+	void testSkippingUpToTheLargestCoordinates() { //The furthest both ways that fits into 32 bit coordinates.
+		for (bool reversed : { false, true }) {
+			Cells cells;
+			testing::loadWorld(cells, reversed ? reversedGlider : glider);
+			findCycle(cells);
+			const Cells::generationType start = cells.getGeneration();
+			const std::vector<Position> before = getAliveCells(cells);
+			runTo(cells, start + 8000000000ull);
+
+			const Position::coordType distance = reversed ? -2000000000 : 2000000000;
+			const Position offset{ distance, distance };
+			const std::vector<Position> after = getAliveCells(cells);
+			CHECK(cells.getGeneration() == start + 8000000000ull);
+			CHECK(after.size() == before.size());
+			for (std::size_t i = 0; i < std::min(after.size(), before.size()); ++i)
+				CHECK(after[i] == before[i] + offset);
+		}
+	}
+
+	void testSkippingBeyondTheLargestCoordinates() { //Refused with 32 bit coordinates, leaving the world as it was. Done with 64 bit coordinates.
+		for (bool reversed : { false, true }) {
+			Cells cells;
+			testing::loadWorld(cells, reversed ? reversedGlider : glider);
+			findCycle(cells);
+			const Cells::generationType start = cells.getGeneration();
+			const std::vector<Position> before = getAliveCells(cells);
+
+			if constexpr (sizeof(Position::coordType) == 4) {
+				bool thrown = false;
+				try {
+					cells.skipCycles(start + 10000000000ull);
+				}
+				catch (std::overflow_error &) {
+					thrown = true;
+				}
+				CHECK(thrown);
+				CHECK(cells.getGeneration() == start);
+				CHECK(getAliveCells(cells) == before);
+			}
+			else {
+				runTo(cells, start + 10000000000ull);
+				const Position::coordType distance = reversed ? -2500000000ll : 2500000000ll;
+				CHECK(cells.getGeneration() == start + 10000000000ull);
+				CHECK(getAliveCells(cells).front().y - before.front().y == distance);
+			}
+		}
+	}
+}
+
+int main() {
+	testSkippingMatchesSimulating();
+	testSkippingFarInAWorldThatWrapsAround();
+	testSkippingUpToTheLargestCoordinates();
+	testSkippingBeyondTheLargestCoordinates();
+	return testing::getExitCode();
+}
@@ -0,0 +1,152 @@
+#include "Testing.h"
+#include "ChangeListener.h"
+
+#include <vector>
+#include <set>
+#include <random>
+#include <string>
+#include <chrono>
+#include <utility>
+#include <stdexcept>
+
+namespace {
+	typedef std::set<std::pair<Position::coordType, Position::coordType>> cellSetType; //Ordered, to compare worlds.
+
+	class MirrorListener : public ChangeListener { //Keeps its own copy of the alive cells from what it is told.
+	public:
+		void update(Position pos, bool alive) override {
+			if (alive)
+				cells.emplace(pos.x, pos.y);
+			else
+				cells.erase(std::make_pair(pos.x, pos.y));
+			++updates;
+		}
+
+		void clear() override {
+			cells.clear();
+		}
+
+		cellSetType cells;
+		std::size_t updates{ 0 };
+	};
+
+	cellSetType getAliveCells(const Cells &cells) {
+		cellSetType alive;
+		cells.forEachAliveCell([&](Position pos) {
+			alive.emplace(pos.x, pos.y);
+		});
+		return alive;
+	}
+
+	std::string getSoup(unsigned seed) { //Runs for about a thousand generations before it settles.
+		std::mt19937 random(seed);
+		std::string map;
+		for (int y = 0; y < 40; ++y) {
+			for (int x = 0; x < 40; ++x)
+				map += random() % 2 ? '*' : '#';
+			map += '\n';
+		}
+		return map;
+	}
+
+	template<typename F> bool throwsLogicError(F f) {
+		try {
+			f();
+		}
+		catch (std::logic_error &) {
+			return true;
+		}
+		return false;
+	}
+
+	void testCancelledJump() { //Listeners and history are detached while jumping, and work again from the generation reached once it is cancelled.
+		Cells cells;
+		testing::loadWorld(cells, getSoup(4));
+		MirrorListener listener;
+		cells.addChangeListener(listener);
+		for (int generation = 0; generation < 5; ++generation)
+			cells.updateCells();
+
+		cells.beginJump(100000);
+		for (int slice = 0; slice < 20; ++slice)
+			CHECK(!cells.continueJump(std::chrono::nanoseconds(0))); //At least one generation each.
+		CHECK(cells.getJumping());
+		CHECK(cells.getGeneration() >= 25);
+		CHECK(cells.getGeneration() < 100000);
+
+		const std::size_t updatesWhileJumping = listener.updates;
+		cells.continueJump(std::chrono::nanoseconds(0));
+		CHECK(listener.updates == updatesWhileJumping);
+
+		Cells::changeContainerType edits{ { Position{ 0, 0 }, true } };
+		CHECK(throwsLogicError([&] { cells.applyEdits(edits); }));
+		CHECK(throwsLogicError([&] { cells.stepBackInHistory(); }));
+		CHECK(throwsLogicError([&] { cells.setPause(false); }));
+
+		cells.cancelJump();
+		const Cells::generationType reached = cells.getGeneration();
+		CHECK(!cells.getJumping());
+		CHECK(cells.getLastJump().cancelled);
+		CHECK(cells.getLastJump().from == 5);
+		CHECK(cells.getLastJump().to == reached);
+		CHECK(cells.getCycleDetector() == nullptr); //Only enabled for the jump.
+		CHECK(listener.cells == getAliveCells(cells));
+
+		const auto before = getAliveCells(cells);
+		for (int generation = 0; generation < 3; ++generation)
+			cells.updateCells();
+		CHECK(listener.cells == getAliveCells(cells));
+
+		for (int generation = 0; generation < 3; ++generation)
+			cells.stepBackInHistory();
+		CHECK(cells.getGeneration() == reached);
+		CHECK(getAliveCells(cells) == before);
+		CHECK(listener.cells == before);
+	}
+
+	void testFinishedJump() { //The same world as simulating every generation, with cycle detection left as it was.
+		Cells jumped, simulated;
+		testing::loadWorld(jumped, getSoup(5));
+		testing::loadWorld(simulated, getSoup(5));
+		jumped.setCycleDetection(true);
+		MirrorListener listener;
+		jumped.addChangeListener(listener);
+
+		Cells::JumpReport report = jumped.jumpTo(700);
+		while (simulated.getGeneration() < 700)
+			simulated.updateCells();
+
+		CHECK(!jumped.getJumping());
+		CHECK(!report.cancelled);
+		CHECK(report.error.empty());
+		CHECK(report.to == 700);
+		CHECK(jumped.getGeneration() == 700);
+		CHECK(getAliveCells(jumped) == getAliveCells(simulated));
+		CHECK(listener.cells == getAliveCells(jumped));
+		CHECK(jumped.getCycleDetector() != nullptr);
+	}
+
+	void testJumpIntoThePast() {
+		Cells cells;
+		testing::loadWorld(cells, getSoup(6));
+		for (int generation = 0; generation < 10; ++generation)
+			cells.updateCells();
+
+		bool thrown = false;
+		try {
+			cells.beginJump(5);
+		}
+		catch (std::invalid_argument &) {
+			thrown = true;
+		}
+		CHECK(thrown);
+		CHECK(!cells.getJumping());
+	}
+}
+
+int main() {
+	testCancelledJump();
+	testFinishedJump();
+	testJumpIntoThePast();
+	return testing::getExitCode();
+}
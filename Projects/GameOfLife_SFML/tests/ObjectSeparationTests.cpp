@@ -0,0 +1,115 @@
+#include "Testing.h"
+#include "ObjectSeparation.h"
+#include "RuleKernels.h"
+
+#include <vector>
+#include <random>
+#include <string>
+#include <numeric>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+	bool comparePositions(Position pos1, Position pos2) {
+		return pos1.y < pos2.y || (pos1.y == pos2.y && pos1.x < pos2.x);
+	}
+
+	std::vector<objectType> getSorted(std::vector<objectType> objects) { //Cells sorted within each object, and objects by their first cell, to compare separations.
+		for (objectType &object : objects)
+			std::sort(object.begin(), object.end(), comparePositions);
+		std::sort(objects.begin(), objects.end(), [](const objectType &object1, const objectType &object2) {
+			return comparePositions(object1.front(), object2.front());
+		});
+		return objects;
+	}
+
+	std::vector<objectType> separateByHand(const std::vector<Position> &alive) { //Compares every pair of cells.
+		std::vector<std::size_t> parents(alive.size());
+		std::iota(parents.begin(), parents.end(), 0);
+		auto find = [&](std::size_t cell) {
+			while (parents[cell] != cell)
+				cell = parents[cell];
+			return cell;
+		};
+
+		for (std::size_t i = 0; i < alive.size(); ++i) {
+			for (std::size_t j = i + 1; j < alive.size(); ++j) {
+				if (std::abs(alive[i].x - alive[j].x) <= ObjectSeparator::interactionDistance && std::abs(alive[i].y - alive[j].y) <= ObjectSeparator::interactionDistance)
+					parents[find(i)] = find(j);
+			}
+		}
+
+		std::vector<objectType> objects;
+		std::vector<std::size_t> objectOfRoot(alive.size(), alive.size());
+		for (std::size_t i = 0; i < alive.size(); ++i) {
+			std::size_t root = find(i);
+			if (objectOfRoot[root] == alive.size()) {
+				objectOfRoot[root] = objects.size();
+				objects.emplace_back();
+			}
+			objects[objectOfRoot[root]].push_back(alive[i]);
+		}
+		return getSorted(objects);
+	}
+
+	void setAlive(Cells &cells, const std::vector<Position> &alive) { //In an empty world.
+		testing::loadWorld(cells, "#");
+		Cells::changeContainerType edits;
+		for (Position pos : alive)
+			edits.emplace_back(pos, true);
+		cells.applyEdits(edits);
+	}
+
+	std::size_t countObjects(const std::vector<Position> &alive) {
+		Cells cells;
+		setAlive(cells, alive);
+		return ObjectSeparator(1)(cells).size();
+	}
+
+	void testInteractionDistance() { //Cells two apart share a neighbor, cells three apart do not.
+		CHECK(countObjects({ Position{ 0, 0 }, Position{ 2, 0 } }) == 1);
+		CHECK(countObjects({ Position{ 0, 0 }, Position{ 3, 0 } }) == 2);
+		CHECK(countObjects({ Position{ 0, 0 }, Position{ 2, -2 } }) == 1);
+		CHECK(countObjects({ Position{ 0, 0 }, Position{ 2, 3 } }) == 2);
+		CHECK(countObjects({ Position{ 63, 63 }, Position{ 65, 65 } }) == 1); //Across the corner of a chunk.
+		CHECK(countObjects({ Position{ -1, 0 }, Position{ 1, 0 }, Position{ 4, 0 } }) == 2); //Across the origin.
+	}
+
+	void testRandomCells() { //Thinly spread, so objects cross chunk borders in every direction. The same with one thread and with several.
+		std::mt19937 random(3);
+		std::uniform_int_distribution<Position::coordType> coordinate(-150, 150);
+		std::vector<Position> alive;
+		for (int i = 0; i < 1500; ++i)
+			alive.push_back(Position{ coordinate(random), coordinate(random) });
+		std::sort(alive.begin(), alive.end(), comparePositions);
+		alive.erase(std::unique(alive.begin(), alive.end()), alive.end());
+
+		Cells cells;
+		setAlive(cells, alive);
+		const std::vector<objectType> expected = separateByHand(alive);
+		CHECK(expected.size() > 1);
+		for (unsigned threadCount : { 1u, 4u })
+			CHECK(getSorted(ObjectSeparator(threadCount)(cells)) == expected);
+	}
+
+	void testNames() { //Objects are recognised in any phase and position.
+		Cells cells;
+		testing::loadWorld(cells, " *\n  *\n***\n\n\n\n\n\n          **\n          **\n\n\n\n\n\n\n\n         ***");
+		for (int generation = 0; generation < 3; ++generation)
+			cells.updateCells();
+
+		std::vector<std::string> names;
+		ObjectCatalogue catalogue(RuleMasks(cells.getRules().getTransitionTable()));
+		for (const objectType &object : ObjectSeparator()(cells))
+			names.push_back(catalogue.getName(object));
+		std::sort(names.begin(), names.end());
+		CHECK((names == std::vector<std::string>{ "blinker", "block", "glider" }));
+	}
+}
+
+int main() {
+	testInteractionDistance();
+	testRandomCells();
+	testNames();
+	return testing::getExitCode();
+}
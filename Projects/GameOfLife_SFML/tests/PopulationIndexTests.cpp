@@ -0,0 +1,97 @@
+#include "Testing.h"
+#include "PopulationIndex.h"
+
+#include <random>
+#include <string>
+#include <algorithm>
+
+namespace {
+	std::string getRandomMap(std::mt19937 &random, int width, int height) { //About a third of the cells alive.
+		std::string map;
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x)
+				map += random() % 3 ? '#' : '*';
+			map += '\n';
+		}
+		return map;
+	}
+
+	PopulationIndex::countType countByHand(const Cells &cells, Position min, Position max) {
+		PopulationIndex::countType count = 0;
+		cells.forEachAliveCell([&](Position pos) {
+			count += pos.x >= min.x && pos.x <= max.x && pos.y >= min.y && pos.y <= max.y;
+		});
+		return count;
+	}
+
+	void checkRandomRectangles(std::mt19937 &random, const Cells &cells, PopulationIndex &index, Position::coordType span) { //Rectangles of any size, many of them crossing chunk borders and the origin.
+		std::uniform_int_distribution<Position::coordType> coordinate(-span, span);
+		for (int i = 0; i < 200; ++i) {
+			Position corner1{ coordinate(random), coordinate(random) }, corner2{ coordinate(random), coordinate(random) };
+			Position min{ std::min(corner1.x, corner2.x), std::min(corner1.y, corner2.y) };
+			Position max{ std::max(corner1.x, corner2.x), std::max(corner1.y, corner2.y) };
+
+			PopulationIndex::countType expected = countByHand(cells, min, max);
+			CHECK(index.count(min, max) == expected);
+			CHECK(index.anyAlive(min, max) == (expected > 0));
+		}
+	}
+
+	void testInfiniteWorld() { //Follows the changes of ticks and edits, with cells on both sides of the origin.
+		std::mt19937 random(1);
+		Cells cells;
+		testing::loadWorld(cells, getRandomMap(random, 70, 50));
+		PopulationIndex index;
+		cells.addChangeListener(index);
+		checkRandomRectangles(random, cells, index, 100);
+
+		for (int generation = 0; generation < 30; ++generation)
+			cells.updateCells();
+		checkRandomRectangles(random, cells, index, 100);
+
+		Cells::changeContainerType edits;
+		for (Position::coordType i = -40; i < 40; ++i) {
+			edits.emplace_back(Position{ i, -i * 3 }, true);
+			edits.emplace_back(Position{ i, 5 }, false);
+		}
+		cells.applyEdits(edits);
+		checkRandomRectangles(random, cells, index, 150);
+
+		CHECK(index.count(Position{ -1000, -1000 }, Position{ 1000, 1000 }) == cells.getStatistics().getPopulation());
+		CHECK(!index.anyAlive(Position{ 500, 500 }, Position{ 600, 600 }));
+	}
+
+	void testWorldThatWrapsAround() { //The index is rebuilt when the world is counted again.
+		std::mt19937 random(2);
+		Cells cells;
+		testing::loadWorld(cells, getRandomMap(random, 40, 33), true);
+		PopulationIndex index;
+		cells.addChangeListener(index);
+
+		for (int generation = 0; generation < 20; ++generation)
+			cells.updateCells();
+		checkRandomRectangles(random, cells, index, 50);
+		CHECK(index.count(Position{ 0, 0 }, Position{ 39, 32 }) == cells.getStatistics().getPopulation());
+	}
+
+	void testSingleCells() { //Rectangles of one cell, on and next to the cell, far from the origin.
+		Cells cells;
+		testing::loadWorld(cells, "#");
+		PopulationIndex index;
+		cells.addChangeListener(index);
+
+		Cells::changeContainerType edits{ { Position{ 1000000, -1000000 }, true } };
+		cells.applyEdits(edits);
+		CHECK(index.count(Position{ 1000000, -1000000 }, Position{ 1000000, -1000000 }) == 1);
+		CHECK(index.count(Position{ 1000001, -1000000 }, Position{ 1000001, -1000000 }) == 0);
+		CHECK(index.anyAlive(Position{ 999999, -1000001 }, Position{ 1000000, -1000000 }));
+		CHECK(!index.anyAlive(Position{ 999999, -999999 }, Position{ 1000001, -999990 }));
+	}
+}
+
+int main() {
+	testInfiniteWorld();
+	testWorldThatWrapsAround();
+	testSingleCells();
+	return testing::getExitCode();
+}
@@ -0,0 +1,38 @@
+#ifndef TESTING_H
+#define TESTING_H
+
+#include "Cell.h"
+#include "FileProcessing.h"
+
+#include <iostream>
+#include <string>
+
+//What the tests share. Each test file is an executable of its own, run by ctest, which fails if any CHECK failed. Nothing beyond gol_core is needed.
+
+namespace testing {
+	inline int failures = 0;
+
+	inline void check(bool condition, const char *expression, const char *file, int line) {
+		if (condition)
+			return;
+		++failures;
+		std::cerr << file << ":" << line << ": CHECK(" << expression << ") failed.\n";
+	}
+
+	inline int getExitCode() { //Returned from main.
+		if (failures)
+			std::cerr << failures << " checks failed.\n";
+		return failures ? 1 : 0;
+	}
+
+	constexpr const char *lifeRules = "CELL ALIVE -> DEAD IF N IS LESS THAN 2\nCELL ALIVE -> DEAD IF N IS GREATER THAN 3\nCELL DEAD -> ALIVE IF N IS EQUAL TO 3"; //B3/S23, as in rules.txt.
+
+	inline void loadWorld(Cells &cells, const std::string &mapStr, bool wrapAround = false) { //Under lifeRules, in the map file format.
+		cells.setRules(lifeRules);
+		loadMapFromStr(cells, mapStr, wrapAround);
+	}
+}
+
+#define CHECK(condition) testing::check((condition), #condition, __FILE__, __LINE__)
+
+#endif
\ No newline at end of file